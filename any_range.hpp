@@ -0,0 +1,123 @@
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include "ranger.hpp"
+
+namespace __ranger {
+	// the type erased interface,  one virtual call per batch (not per element)
+	template <typename T>
+	struct AnySource {
+		virtual ~AnySource () = default;
+
+		virtual bool empty () const = 0;
+		virtual size_t next_batch (Range<T*> out) = 0;
+		virtual std::optional<Range<T const*>> contiguous () const = 0;
+		virtual void pop_front (size_t n) = 0;
+	};
+
+	template <typename T, typename R>
+	struct AnySourceOf final : AnySource<T> {
+		using iterator = typename R::iterator;
+
+		static constexpr bool is_contiguous = std::is_pointer_v<iterator> and
+			std::is_same_v<std::remove_cv_t<std::remove_pointer_t<iterator>>, T>;
+
+		R _r;
+
+		explicit AnySourceOf (R r) : _r(r) {}
+
+		bool empty () const override { return this->_r.empty(); }
+
+		size_t next_batch (Range<T*> const out) override {
+			if constexpr(R::is_random_access::value) {
+				auto const n = std::min(out.size(), this->_r.size());
+				std::copy(this->_r.begin(), this->_r.begin() + static_cast<typename R::distance_type>(n), out.begin());
+				this->_r.pop_front(n);
+				return n;
+			} else {
+				size_t n = 0;
+				for (auto it = out.begin(); it != out.end() and not this->_r.empty(); ++it, ++n) {
+					*it = static_cast<T>(this->_r.front());
+					this->_r.pop_front();
+				}
+
+				return n;
+			}
+		}
+
+		std::optional<Range<T const*>> contiguous () const override {
+			if constexpr(is_contiguous) {
+				return Range<T const*>(this->_r.begin(), this->_r.end());
+			} else {
+				return std::nullopt;
+			}
+		}
+
+		void pop_front (size_t n) override {
+			if constexpr(R::is_random_access::value) {
+				this->_r.pop_front(n);
+			} else {
+				for (; n > 0 and not this->_r.empty(); --n) this->_r.pop_front();
+			}
+		}
+	};
+
+	// a type erased range of `T`,  pulled in batches
+	// wraps any range whose elements convert to `T`,  by value (ranges are views,  the elements are not copied)
+	template <typename T>
+	struct AnyRange {
+		static constexpr size_t batch_size = 256 / sizeof(T) > 0 ? 256 / sizeof(T) : 1;
+
+		using value_type = T;
+
+		std::unique_ptr<AnySource<T>> _source;
+
+		template <typename I, typename P>
+		explicit AnyRange (Range<I, P> const r) : _source(std::make_unique<AnySourceOf<T, Range<I, P>>>(r)) {}
+
+		bool empty () const { return this->_source->empty(); }
+
+		// copies up to `out.size()` elements into `out`,  and drops them
+		// returns the number of elements copied,  0 only if empty (or `out` is empty)
+		size_t next_batch (Range<T*> const out) { return this->_source->next_batch(out); }
+
+		// the remaining elements,  if the wrapped range is contiguous (without copying)
+		std::optional<Range<T const*>> contiguous () const { return this->_source->contiguous(); }
+
+		void pop_front (size_t const n = 1) { this->_source->pop_front(n); }
+
+		// calls `f(Range<T const*>)` for consecutive blocks of the remaining elements,  consuming them
+		// contiguous ranges are passed in one block,  others through a `batch_size` buffer
+		template <typename F>
+		void each_batch (F const f) {
+			if (auto const c = this->contiguous()) {
+				auto const n = c->size();
+				f(*c);
+				this->pop_front(n);
+				return;
+			}
+
+			T buffer[batch_size];
+			while (auto const n = this->next_batch(Range<T*>(buffer, buffer + batch_size))) {
+				f(Range<T const*>(buffer, buffer + n));
+			}
+		}
+	};
+}
+
+namespace ranger {
+	template <typename T> using any_range_t = __ranger::AnyRange<T>;
+
+	// containers with data() are wrapped as pointer ranges,  for the contiguous fast path
+	template <typename T, typename R>
+	auto any_range (R&& r) {
+		if constexpr(__ranger::has_data<std::remove_reference_t<R>>::value) {
+			return any_range_t<T>(ptr_range(r));
+		} else {
+			return any_range_t<T>(range(r));
+		}
+	}
+}
@@ -0,0 +1,234 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "ranger.hpp"
+#include "serial.hpp"
+
+using namespace ranger;
+
+// output is CSV, one row per (benchmark, variant, size), suitable for diffing between versions
+//   benchmark,variant,size,iterations,ns_per_op
+// ns_per_op is the best (minimum) of several timed batches
+
+static volatile size_t sink;
+
+template <typename F>
+void bench (char const* name, char const* variant, size_t const n, F const f) {
+	using clock = std::chrono::steady_clock;
+
+	// calibrate the batch size to ~1ms
+	size_t iterations = 1;
+	for (;;) {
+		auto const start = clock::now();
+		for (size_t i = 0; i < iterations; ++i) sink = f();
+		auto const elapsed = clock::now() - start;
+		if (elapsed >= std::chrono::milliseconds(1) or iterations >= (size_t(1) << 30)) break;
+		iterations *= 2;
+	}
+
+	auto best = 1e300;
+	for (auto batch = 0; batch < 10; ++batch) {
+		auto const start = clock::now();
+		for (size_t i = 0; i < iterations; ++i) sink = f();
+		auto const elapsed = std::chrono::duration<double, std::nano>(clock::now() - start).count();
+		best = std::min(best, elapsed / static_cast<double>(iterations));
+	}
+
+	std::printf("%s,%s,%zu,%zu,%.3f\n", name, variant, n, iterations, best);
+}
+
+int main () {
+	std::printf("benchmark,variant,size,iterations,ns_per_op\n");
+
+	for (size_t const n : {16, 256, 4096, 65536}) {
+		auto bytes = std::vector<uint8_t>(n);
+		for (size_t i = 0; i < n; ++i) bytes[i] = static_cast<uint8_t>(i % 251);
+		for (size_t i = 0; i < 4; ++i) bytes[n - 1 - i] = static_cast<uint8_t>(0xff - i); // unique suffix
+
+		auto const r = ptr_range(bytes);
+		auto const p = bytes.data();
+
+		// drop / take
+		bench("drop_take", "ranger", n, [&]() {
+			size_t result = 0;
+			for (size_t i = 0; i < n; i += 7) result += r.drop(i).take(8).size();
+			return result;
+		});
+
+		bench("drop_take", "raw", n, [&]() {
+			size_t result = 0;
+			for (size_t i = 0; i < n; i += 7) result += std::min<size_t>(8, n - i);
+			return result;
+		});
+
+		// contains (needle at the end,  worst case)
+		auto const needle = std::vector<uint8_t>(bytes.end() - 4, bytes.end());
+		auto const nr = ptr_range(needle);
+
+		bench("contains", "ranger", n, [&]() {
+			return static_cast<size_t>(r.contains(nr));
+		});
+
+		bench("contains", "std", n, [&]() {
+			return static_cast<size_t>(std::search(p, p + n, needle.begin(), needle.end()) != p + n);
+		});
+
+		bench("contains", "raw", n, [&]() {
+			for (size_t i = 0; i + needle.size() <= n; ++i) {
+				if (std::memcmp(p + i, needle.data(), needle.size()) == 0) return size_t(1);
+			}
+			return size_t(0);
+		});
+
+		// replace_all (a match every 251 bytes),  into an exactly sized string vs appends
+		auto const text = std::string(bytes.begin(), bytes.end());
+		auto const from = std::string_view("\x01\x02\x03");
+		auto const to = std::string_view("abcdef");
+
+		bench("replace_all", "ranger", n, [&]() {
+			auto result = std::string(replaced_size(text, from, to), '\0');
+			auto out = ptr_range(result);
+			replace_all(text, from, to, out);
+			return result.size();
+		});
+
+		bench("replace_all", "std", n, [&]() {
+			auto result = std::string();
+			size_t i = 0;
+			for (auto j = text.find(from); j != std::string::npos; j = text.find(from, i)) {
+				result.append(text, i, j - i);
+				result.append(to);
+				i = j + from.size();
+			}
+			result.append(text, i, std::string::npos);
+			return result.size();
+		});
+
+		// starts_with (full length match)
+		auto const copy = bytes;
+		auto const cr = ptr_range(copy);
+
+		bench("starts_with", "ranger", n, [&]() {
+			return static_cast<size_t>(r.starts_with(cr));
+		});
+
+		bench("starts_with", "std", n, [&]() {
+			return static_cast<size_t>(std::equal(copy.begin(), copy.end(), p));
+		});
+
+		bench("starts_with", "raw", n, [&]() {
+			return static_cast<size_t>(std::memcmp(p, copy.data(), n) == 0);
+		});
+
+		// count
+		auto const odd = [](uint8_t x) { return (x & 1) != 0; };
+
+		bench("count", "ranger", n, [&]() {
+			return r.count(odd);
+		});
+
+		bench("count", "std", n, [&]() {
+			return static_cast<size_t>(std::count_if(p, p + n, odd));
+		});
+
+		bench("count", "raw", n, [&]() {
+			size_t result = 0;
+			for (size_t i = 0; i < n; ++i) result += p[i] & 1;
+			return result;
+		});
+
+		// serial::read
+		bench("serial_read", "ranger", n, [&]() {
+			size_t result = 0;
+			auto q = r;
+			while (q.size() >= sizeof(uint32_t)) result += serial::read<uint32_t>(q);
+			return result;
+		});
+
+		bench("serial_read", "raw", n, [&]() {
+			size_t result = 0;
+			for (size_t i = 0; i + sizeof(uint32_t) <= n; i += sizeof(uint32_t)) {
+				uint32_t value;
+				std::memcpy(&value, p + i, sizeof(value));
+				result += value;
+			}
+			return result;
+		});
+
+		// sum (floats,  multiple accumulators vs a single dependency chain)
+		auto floats = std::vector<float>(n);
+		for (size_t i = 0; i < n; ++i) floats[i] = static_cast<float>(i % 17);
+		auto const fr = ptr_range(floats);
+
+		bench("sum", "ranger", n, [&]() {
+			return static_cast<size_t>(fr.sum());
+		});
+
+		bench("sum", "raw", n, [&]() {
+			auto result = 0.0f;
+			for (auto const x : floats) result += x;
+			return static_cast<size_t>(result);
+		});
+
+		// gathers (a field of 64 byte records,  in a shuffled order),  by pointer and by index
+		struct Record { uint32_t key; uint8_t padding[60]; };
+		auto records = std::vector<Record>(n * 16);
+		auto pointers = std::vector<Record const*>(n);
+		auto indices = std::vector<uint32_t>(n);
+		for (size_t i = 0; i < n; ++i) {
+			auto const k = (i * 2654435761u) % records.size();
+			records[k].key = static_cast<uint32_t>(i);
+			pointers[i] = &records[k];
+			indices[i] = static_cast<uint32_t>(k);
+		}
+
+		bench("gather_pointers", "ranger", n, [&]() {
+			size_t result = 0;
+			for (auto const r : prefetch_pointee(pointers, 16)) result += r->key;
+			return result;
+		});
+
+		bench("gather_pointers", "raw", n, [&]() {
+			size_t result = 0;
+			for (auto const r : pointers) result += r->key;
+			return result;
+		});
+
+		bench("gather_indices", "ranger", n, [&]() {
+			size_t result = 0;
+			for (auto const k : prefetch_indexed(indices, records.data(), 16)) result += records[k].key;
+			return result;
+		});
+
+		bench("gather_indices", "raw", n, [&]() {
+			size_t result = 0;
+			for (auto const k : indices) result += records[k].key;
+			return result;
+		});
+
+		// OrderedRange::lower_bound
+		auto sorted = std::vector<uint32_t>(n);
+		for (size_t i = 0; i < n; ++i) sorted[i] = static_cast<uint32_t>(i * 3);
+		auto const o = ordered(sorted);
+
+		bench("lower_bound", "ranger", n, [&]() {
+			size_t result = 0;
+			for (uint32_t i = 0; i < 64; ++i) result += static_cast<size_t>(o.lower_bound(i * 97) - o.begin());
+			return result;
+		});
+
+		bench("lower_bound", "std", n, [&]() {
+			size_t result = 0;
+			for (uint32_t i = 0; i < 64; ++i) result += static_cast<size_t>(std::lower_bound(sorted.begin(), sorted.end(), i * 97) - sorted.begin());
+			return result;
+		});
+	}
+
+	return 0;
+}
@@ -0,0 +1,154 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "ranger.hpp"
+
+#if __has_include(<sys/uio.h>)
+#include <sys/uio.h>
+#define RANGER_IOVEC
+#endif
+
+namespace __ranger {
+	// an append only output buffer,  growing in separately allocated chunks
+	// written elements are never moved,  so ranges over them stay valid until clear()
+	//
+	// writers target the free space of the current chunk,  then commit what they wrote:
+	//   auto f = b.reserve(8);
+	//   serial::put<uint64_t>(f, x);
+	//   b.commit(f);
+	template <typename T = uint8_t>
+	struct Buffer {
+		struct Chunk {
+			std::unique_ptr<T[]> data;
+			size_t capacity;
+			size_t size;
+		};
+
+		std::vector<Chunk> _chunks;
+		size_t _current = 0;
+		size_t _chunk_size;
+
+		explicit Buffer (size_t const chunk_size = 4096) : _chunk_size(chunk_size) {}
+
+		// the free space of the current chunk,  possibly empty
+		auto free () {
+			if (this->_chunks.empty()) return Range<T*>(nullptr, nullptr);
+
+			auto& c = this->_chunks[this->_current];
+			return Range<T*>(c.data.get() + c.size, c.data.get() + c.capacity);
+		}
+
+		// free space for at least `n` elements,  contiguous
+		// starts a new chunk if the current one is too small (its free space is left unused)
+		auto reserve (size_t const n) {
+			if (this->free().size() >= n) return this->free();
+
+			// reuse a chunk kept by clear(),  if large enough
+			auto const next = this->_chunks.empty() ? 0 : this->_current + 1;
+			if (next >= this->_chunks.size() or this->_chunks[next].capacity < n) {
+				// default initialized (make_unique would zero trivial types)
+				auto const capacity = std::max(n, this->_chunk_size);
+				this->_chunks.insert(this->_chunks.begin() + static_cast<std::ptrdiff_t>(next), Chunk{std::unique_ptr<T[]>(new T[capacity]), capacity, 0});
+			}
+
+			this->_current = next;
+			return this->free();
+		}
+
+		// marks the free space before `rest` as written,  `rest` as left by a writer given reserve() or free()
+		// before the first chunk,  free() is empty and there is nothing to commit
+		void commit (Range<T*> const rest) {
+			if (this->_chunks.empty()) {
+				assert(rest.empty());
+				return;
+			}
+
+			auto& c = this->_chunks[this->_current];
+			assert(rest.begin() >= c.data.get() + c.size and rest.begin() <= c.data.get() + c.capacity);
+			c.size = static_cast<size_t>(rest.begin() - c.data.get());
+		}
+
+		void commit (size_t const n) {
+			if (this->_chunks.empty()) {
+				assert(n == 0);
+				return;
+			}
+
+			auto& c = this->_chunks[this->_current];
+			assert(c.size + n <= c.capacity);
+			c.size += n;
+		}
+
+		// appends `r`,  split across chunks as needed
+		template <typename R>
+		void put (R const& r) {
+			auto a = ranger::range(r);
+
+			while (not a.empty()) {
+				auto f = this->free();
+				if (f.empty()) f = this->reserve(1);
+
+				size_t n = 0;
+				if constexpr(decltype(a)::is_random_access::value) {
+					n = std::min(f.size(), a.size());
+					std::copy(a.begin(), a.begin() + static_cast<typename decltype(a)::distance_type>(n), f.begin());
+					a.pop_front(n);
+				} else {
+					for (auto it = f.begin(); it != f.end() and not a.empty(); ++it, ++n) {
+						*it = a.front();
+						a.pop_front();
+					}
+				}
+
+				this->commit(n);
+			}
+		}
+
+		// the number of elements written
+		auto size () const {
+			size_t result = 0;
+			for (auto const& c : this->_chunks) result += c.size;
+			return result;
+		}
+
+		auto empty () const { return this->size() == 0; }
+
+		// the written elements,  one range per chunk,  e.g. for ranger::chain
+		auto segments () const {
+			auto result = std::vector<Range<T const*>>{};
+
+			for (auto const& c : this->_chunks) {
+				if (c.size > 0) result.emplace_back(c.data.get(), c.data.get() + c.size);
+			}
+
+			return result;
+		}
+
+#ifdef RANGER_IOVEC
+		// the written elements,  for writev
+		auto iovecs () const {
+			auto result = std::vector<iovec>{};
+
+			for (auto const& c : this->_chunks) {
+				if (c.size > 0) result.push_back(iovec{c.data.get(), c.size * sizeof(T)});
+			}
+
+			return result;
+		}
+#endif
+
+		// forgets the written elements,  keeping the chunks for reuse
+		void clear () {
+			for (auto& c : this->_chunks) c.size = 0;
+			this->_current = 0;
+		}
+	};
+}
+
+namespace ranger {
+	template <typename T = uint8_t> using buffer_t = __ranger::Buffer<T>;
+}
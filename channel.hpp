@@ -0,0 +1,228 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <type_traits>
+#include "ranger.hpp"
+
+namespace __ranger {
+	// waits for `f()`,  spinning briefly before yielding the thread
+	template <typename F>
+	bool wait_until (F const f) {
+		for (size_t i = 0; not f(); ++i) {
+			if (i >= 64) std::this_thread::yield();
+		}
+
+		return true;
+	}
+
+	template <typename T>
+	struct Channel;
+
+	// an input iterator over the values received from a Channel,  a default constructed iterator is the end
+	template <typename T>
+	struct ChannelIterator {
+		using iterator_category = std::input_iterator_tag;
+		using value_type = T;
+		using difference_type = std::ptrdiff_t;
+		using pointer = T const*;
+		using reference = T const&;
+
+		Channel<T>* _channel = nullptr;
+		T _value = T();
+
+		ChannelIterator () = default;
+		explicit ChannelIterator (Channel<T>& channel) : _channel(&channel) { ++*this; }
+
+		reference operator* () const { return this->_value; }
+		pointer operator-> () const { return &this->_value; }
+
+		auto& operator++ () {
+			if (not this->_channel->get(this->_value)) this->_channel = nullptr;
+			return *this;
+		}
+
+		auto operator++ (int) {
+			auto copy = *this;
+			++*this;
+			return copy;
+		}
+
+		bool operator== (ChannelIterator const& b) const { return this->_channel == b._channel; }
+		bool operator!= (ChannelIterator const& b) const { return this->_channel != b._channel; }
+	};
+
+	// a lock-free single producer, single consumer ring buffer
+	// the producer calls put/try_put/close,  the consumer calls get/try_get or iterates begin()..end()
+	template <typename T>
+	struct Channel {
+		static_assert(std::is_default_constructible_v<T> and std::is_copy_assignable_v<T>, "Expected a default constructible, copy assignable type");
+		static constexpr size_t cache_line = 64;
+
+		using value_type = T;
+		using iterator = ChannelIterator<T>;
+
+		std::unique_ptr<T[]> _buffer;
+		size_t _mask;
+
+		// consumer
+		alignas(cache_line) std::atomic<size_t> _head{0};
+		size_t _cached_tail = 0;
+
+		// producer
+		alignas(cache_line) std::atomic<size_t> _tail{0};
+		size_t _cached_head = 0;
+
+		// polled by the consumer while waiting,  kept off the producer's line
+		alignas(cache_line) std::atomic<bool> _closed{false};
+
+		// `capacity` is rounded up to a power of two
+		explicit Channel (size_t const capacity) {
+			size_t n = 1;
+			while (n < capacity) n <<= 1;
+
+			this->_buffer = std::make_unique<T[]>(n);
+			this->_mask = n - 1;
+		}
+
+		Channel (Channel const&) = delete;
+		Channel& operator= (Channel const&) = delete;
+
+		auto capacity () const { return this->_mask + 1; }
+
+		// producer side
+
+		// the free space after `tail`,  reloading the cached head only if it shows less than `wanted`
+		size_t free_after (size_t const tail, size_t const wanted) {
+			auto const free = this->capacity() - (tail - this->_cached_head);
+			if (free >= wanted) return free;
+
+			this->_cached_head = this->_head.load(std::memory_order_acquire);
+			return this->capacity() - (tail - this->_cached_head);
+		}
+
+		// writes the longest prefix of `r` that fits,  without waiting
+		// returns the number of elements written
+		template <typename R>
+		size_t try_put (R const& r) {
+			auto a = ranger::range(r);
+			auto const tail = this->_tail.load(std::memory_order_relaxed);
+
+			size_t n = 0;
+			if constexpr(decltype(a)::is_random_access::value) {
+				auto const free = this->free_after(tail, a.size());
+
+				// at most two contiguous copies,  either side of the wrap
+				n = std::min(free, a.size());
+				auto const i = tail & this->_mask;
+				auto const m = std::min(n, this->capacity() - i);
+				std::copy(a.begin(), a.begin() + static_cast<std::ptrdiff_t>(m), this->_buffer.get() + i);
+				std::copy(a.begin() + static_cast<std::ptrdiff_t>(m), a.begin() + static_cast<std::ptrdiff_t>(n), this->_buffer.get());
+			} else {
+				// the size is unknown,  so reload once the cached space runs out
+				auto free = this->free_after(tail, 1);
+				for (; not a.empty(); ++n) {
+					if (n == free) {
+						free = this->free_after(tail, n + 1);
+						if (n == free) break;
+					}
+
+					this->_buffer[(tail + n) & this->_mask] = a.front();
+					a.pop_front();
+				}
+			}
+
+			if (n > 0) this->_tail.store(tail + n, std::memory_order_release);
+			return n;
+		}
+
+		// writes all of `r`,  waiting for space as needed
+		template <typename R>
+		void put (R const& r) {
+			auto a = ranger::range(r);
+
+			while (not a.empty()) {
+				auto const n = this->try_put(a);
+				if (n > 0) {
+					a.pop_front(n);
+					continue;
+				}
+
+				wait_until([&]() { return this->_head.load(std::memory_order_acquire) != this->_cached_head; });
+			}
+		}
+
+		// no more values will be put,  the consumer ends after the values already written
+		void close () {
+			this->_closed.store(true, std::memory_order_release);
+		}
+
+		// consumer side
+
+		// reads up to `out.size()` values into `out`,  without waiting
+		// returns the number of values read
+		template <typename R>
+		size_t try_get (R&& out) {
+			auto o = ranger::range(out);
+			auto const head = this->_head.load(std::memory_order_relaxed);
+
+			auto available = this->_cached_tail - head;
+			if (available == 0) {
+				this->_cached_tail = this->_tail.load(std::memory_order_acquire);
+				available = this->_cached_tail - head;
+			}
+
+			size_t n = 0;
+			if constexpr(decltype(o)::is_random_access::value) {
+				n = std::min(available, o.size());
+				auto const i = head & this->_mask;
+				auto const m = std::min(n, this->capacity() - i);
+				auto const b = this->_buffer.get();
+				std::copy(b + i, b + i + m, o.begin());
+				std::copy(b, b + (n - m), o.begin() + static_cast<std::ptrdiff_t>(m));
+			} else {
+				for (; n < available and not o.empty(); ++n) {
+					o.front() = this->_buffer[(head + n) & this->_mask];
+					o.pop_front();
+				}
+			}
+
+			if (n > 0) this->_head.store(head + n, std::memory_order_release);
+			return n;
+		}
+
+		// reads up to `out.size()` values into `out`,  waiting until at least one is available
+		// returns 0 only if `out` is empty,  or the channel is closed and drained
+		template <typename R>
+		size_t get (R&& out) {
+			if (ranger::range(out).empty()) return 0;
+
+			size_t n = 0;
+			wait_until([&]() {
+				// read closed before the last try,  so no values written before close are missed
+				auto const closed = this->_closed.load(std::memory_order_acquire);
+				n = this->try_get(out);
+				return n > 0 or closed;
+			});
+
+			return n;
+		}
+
+		// reads one value,  waiting until available
+		// returns false if the channel is closed and drained
+		bool get (T& value) {
+			return this->get(ranger::range(&value, &value + 1)) == 1;
+		}
+
+		iterator begin () { return iterator(*this); }
+		iterator end () { return iterator(); }
+	};
+}
+
+namespace ranger {
+	template <typename T> using channel_t = __ranger::Channel<T>;
+	template <typename T> using channel_iterator_t = __ranger::ChannelIterator<T>;
+}
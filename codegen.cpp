@@ -0,0 +1,43 @@
+#include <cstddef>
+
+#include "ranger.hpp"
+
+// each `ranger_X` is compared against `raw_X` by codegen.sh,
+// the ranger variant must not compile (at -O2 -DNDEBUG) to more instructions,  or any calls
+
+using namespace ranger;
+
+extern "C" {
+	int ranger_front (int const* b, int const* e) { return range(b, e).front(); }
+	int raw_front (int const* b, int const*) { return *b; }
+
+	int ranger_back (int const* b, int const* e) { return range(b, e).back(); }
+	int raw_back (int const*, int const* e) { return e[-1]; }
+
+	int ranger_index (int const* b, int const* e, size_t i) { return range(b, e)[i]; }
+	int raw_index (int const* b, int const*, size_t i) { return b[i]; }
+
+	size_t ranger_size (int const* b, int const* e) { return range(b, e).size(); }
+	size_t raw_size (int const* b, int const* e) { return static_cast<size_t>(e - b); }
+
+	bool ranger_empty (int const* b, int const* e) { return range(b, e).empty(); }
+	bool raw_empty (int const* b, int const* e) { return b == e; }
+
+	// drop and take are clamped to the range
+	int const* ranger_drop (int const* b, int const* e, size_t i) { return range(b, e).drop(i).begin(); }
+	int const* raw_drop (int const* b, int const* e, size_t i) {
+		return b + (i < static_cast<size_t>(e - b) ? i : static_cast<size_t>(e - b));
+	}
+
+	int const* ranger_take (int const* b, int const* e, size_t i) { return range(b, e).take(i).end(); }
+	int const* raw_take (int const* b, int const* e, size_t i) {
+		return b + (i < static_cast<size_t>(e - b) ? i : static_cast<size_t>(e - b));
+	}
+
+	// unchecked drop and take are plain pointer arithmetic
+	int const* ranger_unchecked_drop (int const* b, int const* e, size_t i) { return unchecked(range(b, e)).drop(i).begin(); }
+	int const* raw_unchecked_drop (int const* b, int const*, size_t i) { return b + i; }
+
+	int const* ranger_unchecked_take (int const* b, int const* e, size_t i) { return unchecked(range(b, e)).take(i).end(); }
+	int const* raw_unchecked_take (int const* b, int const*, size_t i) { return b + i; }
+}
@@ -0,0 +1,32 @@
+#!/bin/sh
+# compares the instruction counts of ranger_X against raw_X in codegen.cpp
+# usage: codegen.sh <compiler> [flags...]
+set -e
+
+CXX=${1:-clang++}
+[ $# -gt 0 ] && shift
+ASM=$($CXX "$@" -O2 -DNDEBUG -fno-asynchronous-unwind-tables -S codegen.cpp -o -)
+
+# prints "<function> <instructions> <calls>" for every function in the assembly
+COUNTS=$(echo "$ASM" | awk '
+	/^[A-Za-z_][A-Za-z0-9_]*:/ { name = substr($1, 1, length($1) - 1); n[name] = 0; c[name] = 0; next }
+	/^[ \t]+\./ || /^\./ || /^[ \t]*$/ || /^[ \t]*#/ { next }
+	/^[ \t]/ && name != "" { n[name]++; if ($1 ~ /^(call|bl|jmp)/ && $2 !~ /^\./) c[name]++ }
+	END { for (f in n) print f, n[f], c[f] }
+')
+
+failed=0
+for f in $(echo "$COUNTS" | awk '$1 ~ /^ranger_/ { print substr($1, 8) }' | sort); do
+	ours=$(echo "$COUNTS" | awk -v f="ranger_$f" '$1 == f { print $2, $3 }')
+	theirs=$(echo "$COUNTS" | awk -v f="raw_$f" '$1 == f { print $2, $3 }')
+	set -- $ours $theirs
+
+	if [ "$1" -gt "$3" ] || [ "$2" -gt "$4" ]; then
+		echo "fail $f: ranger $1 instructions ($2 calls), raw $3 instructions ($4 calls)"
+		failed=1
+	else
+		echo "ok $f: ranger $1 instructions, raw $3 instructions"
+	fi
+done
+
+exit $failed
@@ -0,0 +1,253 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <type_traits>
+#include "ranger.hpp"
+
+namespace __ranger {
+	template <typename R>
+	auto byte_pointer (R const& r) {
+		static_assert(is_byte_pointer<typename R::iterator>(), "Expected a byte pointer range");
+		return reinterpret_cast<uint8_t const*>(r.begin());
+	}
+
+	template <typename R>
+	auto mutable_byte_pointer (R const& r) {
+		static_assert(is_byte_pointer<typename R::iterator>(), "Expected a byte pointer range");
+		static_assert(not std::is_const_v<std::remove_pointer_t<typename R::iterator>>, "Expected a mutable range");
+		return reinterpret_cast<uint8_t*>(r.begin());
+	}
+
+	// byte -> its two hex digits
+	constexpr auto hex_pairs (char const* const digits) {
+		auto t = std::array<std::array<uint8_t, 2>, 256>{};
+		for (size_t i = 0; i < 256; ++i) {
+			t[i][0] = static_cast<uint8_t>(digits[i >> 4]);
+			t[i][1] = static_cast<uint8_t>(digits[i & 15]);
+		}
+
+		return t;
+	}
+
+	// character -> its value,  0xFF if not in `alphabet`
+	constexpr auto decode_table (char const* const alphabet) {
+		auto t = std::array<uint8_t, 256>{};
+		for (auto& x : t) x = 0xFF;
+		for (size_t i = 0; alphabet[i] != '\0'; ++i) t[static_cast<uint8_t>(alphabet[i])] = static_cast<uint8_t>(i);
+		return t;
+	}
+
+	inline constexpr auto hex_lower = hex_pairs("0123456789abcdef");
+	inline constexpr auto hex_upper = hex_pairs("0123456789ABCDEF");
+	inline constexpr auto hex_values = [] {
+		auto t = decode_table("0123456789abcdef");
+		for (uint8_t i = 0; i < 6; ++i) t['A' + i] = static_cast<uint8_t>(10 + i);
+		return t;
+	}();
+
+	inline constexpr char base64_alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+	inline constexpr auto base64_values = decode_table(base64_alphabet);
+}
+
+// hex (base16),  lower case by default,  either case decoded
+namespace ranger::hex {
+	constexpr size_t encoded_size (size_t const n) { return 2 * n; }
+
+	// the decoded size of `in`,  if valid
+	template <typename R>
+	constexpr size_t decoded_size (R const& in) { return in.size() / 2; }
+
+	// encodes all of `in` into `out`,  advancing both
+	// returns false (writing nothing) if `out` is too small
+	template <typename A, typename B>
+	bool encode (A& in, B& out, bool const upper = false) {
+		auto const n = in.size();
+		if (out.size() < encoded_size(n)) return false;
+
+		auto const p = __ranger::byte_pointer(in);
+		auto const o = __ranger::mutable_byte_pointer(out);
+		auto const& table = upper ? __ranger::hex_upper : __ranger::hex_lower;
+
+		for (size_t i = 0; i < n; ++i) {
+			auto const& pair = table[p[i]];
+			o[2 * i] = pair[0];
+			o[2 * i + 1] = pair[1];
+		}
+
+		in = in.drop(n);
+		out = out.drop(encoded_size(n));
+		return true;
+	}
+
+	// decodes all of `in` into `out`,  advancing both
+	// returns false if `out` is too small (writing nothing),
+	// or at an invalid character (or an odd trailing one),  with `in` left at it and `out` past the bytes before it
+	template <typename A, typename B>
+	bool decode (A& in, B& out) {
+		auto const n = in.size();
+		auto const m = decoded_size(in);
+		if (out.size() < m) return false;
+
+		auto const p = __ranger::byte_pointer(in);
+		auto const o = __ranger::mutable_byte_pointer(out);
+		auto const& table = __ranger::hex_values;
+
+		auto const fail = [&](size_t const i) {
+			in = in.drop(i);
+			out = out.drop(i / 2);
+			return false;
+		};
+
+		size_t i = 0;
+
+		// 8 bytes at a time,  checking for errors once per block
+		for (; i + 8 <= m; i += 8) {
+			uint8_t error = 0;
+			for (size_t j = i; j < i + 8; ++j) {
+				auto const hi = table[p[2 * j]];
+				auto const lo = table[p[2 * j + 1]];
+				error |= hi | lo;
+				o[j] = static_cast<uint8_t>((hi << 4) | (lo & 0x0F));
+			}
+
+			if (error & 0x80) break;
+		}
+
+		for (; i < m; ++i) {
+			auto const hi = table[p[2 * i]];
+			auto const lo = table[p[2 * i + 1]];
+			if (hi & 0x80) return fail(2 * i);
+			if (lo & 0x80) return fail(2 * i + 1);
+			o[i] = static_cast<uint8_t>((hi << 4) | lo);
+		}
+
+		if (n % 2 != 0) return fail(n - 1);
+
+		in = in.drop(n);
+		out = out.drop(m);
+		return true;
+	}
+}
+
+// base64 (RFC 4648),  standard alphabet and padding
+namespace ranger::base64 {
+	constexpr size_t encoded_size (size_t const n) { return (n + 2) / 3 * 4; }
+
+	// the exact decoded size of `in`,  if valid
+	template <typename R>
+	size_t decoded_size (R const& in) {
+		auto const n = in.size();
+		auto const p = __ranger::byte_pointer(in);
+
+		size_t padding = 0;
+		if (n >= 4 and n % 4 == 0) padding = (p[n - 1] == '=') + (p[n - 1] == '=' and p[n - 2] == '=');
+
+		return n / 4 * 3 - padding;
+	}
+
+	// encodes all of `in` into `out`,  advancing both
+	// returns false (writing nothing) if `out` is too small
+	template <typename A, typename B>
+	bool encode (A& in, B& out) {
+		auto const n = in.size();
+		if (out.size() < encoded_size(n)) return false;
+
+		auto const p = __ranger::byte_pointer(in);
+		auto const o = __ranger::mutable_byte_pointer(out);
+		auto const digit = [](uint32_t const x) { return static_cast<uint8_t>(__ranger::base64_alphabet[x & 0x3F]); };
+
+		size_t i = 0;
+		size_t j = 0;
+		for (; i + 3 <= n; i += 3, j += 4) {
+			auto const x = (uint32_t(p[i]) << 16) | (uint32_t(p[i + 1]) << 8) | p[i + 2];
+			o[j] = digit(x >> 18);
+			o[j + 1] = digit(x >> 12);
+			o[j + 2] = digit(x >> 6);
+			o[j + 3] = digit(x);
+		}
+
+		if (i < n) {
+			auto const two = i + 1 < n;
+			auto const x = (uint32_t(p[i]) << 16) | (two ? uint32_t(p[i + 1]) << 8 : 0);
+			o[j] = digit(x >> 18);
+			o[j + 1] = digit(x >> 12);
+			o[j + 2] = two ? digit(x >> 6) : '=';
+			o[j + 3] = '=';
+		}
+
+		in = in.drop(n);
+		out = out.drop(encoded_size(n));
+		return true;
+	}
+
+	// decodes all of `in` (padded,  a multiple of 4 characters) into `out`,  advancing both
+	// returns false if `out` is too small (writing nothing),
+	// or at an invalid character (misplaced padding,  or non-zero bits before it),  with `in` left at it and `out` past the bytes of the quads before it
+	// an incomplete final quad leaves `in` at its start
+	template <typename A, typename B>
+	bool decode (A& in, B& out) {
+		auto const n = in.size();
+		auto const m = decoded_size(in);
+		if (out.size() < m) return false;
+
+		auto const p = __ranger::byte_pointer(in);
+		auto const o = __ranger::mutable_byte_pointer(out);
+		auto const& table = __ranger::base64_values;
+
+		auto const fail = [&](size_t const i) {
+			in = in.drop(i);
+			out = out.drop(i / 4 * 3);
+			return false;
+		};
+
+		auto const quads = n / 4;
+		auto const last = m % 3 != 0 ? quads - 1 : quads; // the padded quad,  if any
+
+		size_t q = 0;
+		for (; q < last; ++q) {
+			auto const s = p + 4 * q;
+			auto const a = table[s[0]];
+			auto const b = table[s[1]];
+			auto const c = table[s[2]];
+			auto const d = table[s[3]];
+
+			if ((a | b | c | d) & 0x80) {
+				for (size_t k = 0; k < 4; ++k) {
+					if (table[s[k]] & 0x80) return fail(4 * q + k);
+				}
+			}
+
+			auto const x = (uint32_t(a) << 18) | (uint32_t(b) << 12) | (uint32_t(c) << 6) | d;
+			o[3 * q] = static_cast<uint8_t>(x >> 16);
+			o[3 * q + 1] = static_cast<uint8_t>(x >> 8);
+			o[3 * q + 2] = static_cast<uint8_t>(x);
+		}
+
+		if (q < quads) {
+			auto const s = p + 4 * q;
+			auto const bytes = m % 3; // 1 or 2
+			auto const a = table[s[0]];
+			auto const b = table[s[1]];
+			auto const c = bytes == 2 ? table[s[2]] : uint8_t(0);
+
+			if (a & 0x80) return fail(4 * q);
+			if (b & 0x80) return fail(4 * q + 1);
+			if (c & 0x80) return fail(4 * q + 2);
+
+			// canonical,  the bits below the last byte are zero
+			if (bytes == 1 and (b & 0x0F) != 0) return fail(4 * q + 1);
+			if (bytes == 2 and (c & 0x03) != 0) return fail(4 * q + 2);
+
+			auto const x = (uint32_t(a) << 18) | (uint32_t(b) << 12) | (uint32_t(c) << 6);
+			o[3 * q] = static_cast<uint8_t>(x >> 16);
+			if (bytes == 2) o[3 * q + 1] = static_cast<uint8_t>(x >> 8);
+		}
+
+		if (n % 4 != 0) return fail(n - n % 4);
+
+		in = in.drop(n);
+		out = out.drop(m);
+		return true;
+	}
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+// C++20 only,  empty otherwise (see RANGER_GENERATOR)
+#if __cplusplus >= 202002L and __has_include(<coroutine>)
+#define RANGER_GENERATOR
+
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <utility>
+#include "ranger.hpp"
+
+namespace __ranger {
+	// a coroutine yielding values of `T`,  by reference to the value in the (suspended) coroutine
+	// coroutine frames are allocated with (a default constructed) `A`
+	//
+	// the iterator is an input iterator,  default constructed as the end,  so
+	//   auto g = walk(tree);
+	//   auto r = ranger::input_range(g.begin());
+	template <typename T, typename A>
+	struct Generator {
+		struct promise_type {
+			T const* _value = nullptr;
+			std::exception_ptr _exception;
+
+			auto get_return_object () { return Generator(std::coroutine_handle<promise_type>::from_promise(*this)); }
+			std::suspend_always initial_suspend () noexcept { return {}; }
+			std::suspend_always final_suspend () noexcept { return {}; }
+			void return_void () noexcept {}
+			void unhandled_exception () { this->_exception = std::current_exception(); }
+
+			// `v` outlives the suspension,  as a temporary in the co_yield expression if need be
+			std::suspend_always yield_value (T const& v) noexcept {
+				this->_value = std::addressof(v);
+				return {};
+			}
+
+			// frames are allocated as arrays of max_align_t
+			using allocator = typename std::allocator_traits<A>::template rebind_alloc<std::max_align_t>;
+
+			static auto blocks (size_t const n) { return (n + sizeof(std::max_align_t) - 1) / sizeof(std::max_align_t); }
+
+			static void* operator new (size_t const n) {
+				auto a = allocator();
+				return std::allocator_traits<allocator>::allocate(a, blocks(n));
+			}
+
+			static void operator delete (void* const p, size_t const n) {
+				auto a = allocator();
+				std::allocator_traits<allocator>::deallocate(a, static_cast<std::max_align_t*>(p), blocks(n));
+			}
+		};
+
+		using handle = std::coroutine_handle<promise_type>;
+
+		struct iterator {
+			using iterator_category = std::input_iterator_tag;
+			using value_type = T;
+			using difference_type = std::ptrdiff_t;
+			using pointer = T const*;
+			using reference = T const&;
+
+			handle _h = nullptr;
+
+			iterator () = default;
+			explicit iterator (handle const h) : _h(h) {}
+
+			reference operator* () const { return *this->_h.promise()._value; }
+			pointer operator-> () const { return this->_h.promise()._value; }
+
+			auto& operator++ () {
+				this->_h.resume();
+				rethrow(this->_h);
+				return *this;
+			}
+
+			void operator++ (int) { ++*this; }
+
+			bool done () const { return not this->_h or this->_h.done(); }
+			bool operator== (iterator const& b) const { return this->done() == b.done(); }
+			bool operator!= (iterator const& b) const { return this->done() != b.done(); }
+		};
+
+		handle _h;
+
+		explicit Generator (handle const h) : _h(h) {}
+		Generator (Generator&& g) noexcept : _h(std::exchange(g._h, nullptr)) {}
+		Generator& operator= (Generator g) noexcept { std::swap(this->_h, g._h); return *this; }
+		~Generator () { if (this->_h) this->_h.destroy(); }
+
+		static void rethrow (handle const h) {
+			if (h.done() and h.promise()._exception) std::rethrow_exception(h.promise()._exception);
+		}
+
+		// runs to the first value,  call once
+		auto begin () {
+			this->_h.resume();
+			rethrow(this->_h);
+			return iterator(this->_h);
+		}
+
+		auto end () const { return iterator(); }
+	};
+}
+
+namespace ranger {
+	template <typename T, typename A = std::allocator<std::byte>> using generator = __ranger::Generator<T, A>;
+}
+
+#endif
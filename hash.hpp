@@ -0,0 +1,170 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <type_traits>
+#include "ranger.hpp"
+
+namespace __ranger {
+	// streaming XXH64,  four independent lanes over 32 byte stripes
+	struct XXH64 {
+		static constexpr uint64_t P1 = 0x9E3779B185EBCA87ULL;
+		static constexpr uint64_t P2 = 0xC2B2AE3D27D4EB4FULL;
+		static constexpr uint64_t P3 = 0x165667B19E3779F9ULL;
+		static constexpr uint64_t P4 = 0x85EBCA77C2B2AE63ULL;
+		static constexpr uint64_t P5 = 0x27D4EB2F165667C5ULL;
+
+		uint64_t _seed;
+		uint64_t _v[4];
+		uint64_t _length = 0;
+		uint8_t _buffer[32] = {};
+		size_t _buffered = 0;
+
+		explicit XXH64 (uint64_t const seed = 0) : _seed(seed), _v{seed + P1 + P2, seed + P2, seed, seed - P1} {}
+
+		static uint64_t rotl (uint64_t const x, int const r) {
+			return (x << r) | (x >> (64 - r));
+		}
+
+		static uint64_t read64 (uint8_t const* p) {
+			uint64_t x;
+			std::memcpy(&x, p, sizeof(x));
+			return x;
+		}
+
+		static uint32_t read32 (uint8_t const* p) {
+			uint32_t x;
+			std::memcpy(&x, p, sizeof(x));
+			return x;
+		}
+
+		static uint64_t round (uint64_t acc, uint64_t const input) {
+			acc += input * P2;
+			acc = rotl(acc, 31);
+			return acc * P1;
+		}
+
+		static uint64_t merge (uint64_t acc, uint64_t const v) {
+			acc ^= round(0, v);
+			return acc * P1 + P4;
+		}
+
+		void stripe (uint8_t const* p) {
+			this->_v[0] = round(this->_v[0], read64(p));
+			this->_v[1] = round(this->_v[1], read64(p + 8));
+			this->_v[2] = round(this->_v[2], read64(p + 16));
+			this->_v[3] = round(this->_v[3], read64(p + 24));
+		}
+
+		void update (uint8_t const* p, size_t n) {
+			this->_length += n;
+
+			if (this->_buffered > 0) {
+				auto const fill = std::min(n, sizeof(this->_buffer) - this->_buffered);
+				std::memcpy(this->_buffer + this->_buffered, p, fill);
+				this->_buffered += fill;
+				p += fill;
+				n -= fill;
+
+				if (this->_buffered < sizeof(this->_buffer)) return;
+				this->stripe(this->_buffer);
+				this->_buffered = 0;
+			}
+
+			for (; n >= 32; p += 32, n -= 32) this->stripe(p);
+
+			std::memcpy(this->_buffer, p, n);
+			this->_buffered = n;
+		}
+
+		uint64_t digest () const {
+			uint64_t h;
+
+			if (this->_length >= 32) {
+				h = rotl(this->_v[0], 1) + rotl(this->_v[1], 7) + rotl(this->_v[2], 12) + rotl(this->_v[3], 18);
+				for (auto const v : this->_v) h = merge(h, v);
+			} else {
+				h = this->_seed + P5;
+			}
+
+			h += this->_length;
+
+			auto p = this->_buffer;
+			auto n = this->_buffered;
+
+			for (; n >= 8; p += 8, n -= 8) {
+				h ^= round(0, read64(p));
+				h = rotl(h, 27) * P1 + P4;
+			}
+
+			if (n >= 4) {
+				h ^= static_cast<uint64_t>(read32(p)) * P1;
+				h = rotl(h, 23) * P2 + P3;
+				p += 4;
+				n -= 4;
+			}
+
+			for (; n > 0; ++p, --n) {
+				h ^= *p * P5;
+				h = rotl(h, 11) * P1;
+			}
+
+			h ^= h >> 33;
+			h *= P2;
+			h ^= h >> 29;
+			h *= P3;
+			h ^= h >> 32;
+			return h;
+		}
+	};
+}
+
+namespace ranger {
+	// a 64-bit hash of the elements of `r`,  equal for equal elements regardless of the range type
+	// contiguous ranges (and containers with data()) of integral elements are hashed as bytes in one pass (XXH64),
+	// other ranges feed each element (or its std::hash,  if not integral) into the same state
+	template <typename R>
+	uint64_t hash (R const& r, uint64_t const seed = 0) {
+		auto const a = contiguous_range(r);
+		using iterator = typename decltype(a)::iterator;
+		using value_type = typename decltype(a)::value_type;
+
+		auto state = __ranger::XXH64(seed);
+
+		if constexpr(std::is_pointer_v<iterator> and std::is_integral_v<value_type>) {
+			state.update(reinterpret_cast<uint8_t const*>(a.begin()), a.size() * sizeof(value_type));
+		} else if constexpr(std::is_integral_v<value_type>) {
+			for (auto const x : a) {
+				state.update(reinterpret_cast<uint8_t const*>(&x), sizeof(x));
+			}
+		} else {
+			for (auto const& x : a) {
+				auto const h = static_cast<uint64_t>(std::hash<value_type>()(x));
+				state.update(reinterpret_cast<uint8_t const*>(&h), sizeof(h));
+			}
+		}
+
+		return state.digest();
+	}
+
+	// std::unordered_* adaptors,  e.g. std::unordered_set<range_t<char const*>, range_hash, range_equal>
+	// transparent,  so any range type can be used for lookup (where supported)
+	struct range_hash {
+		using is_transparent = void;
+
+		template <typename R>
+		size_t operator() (R const& r) const {
+			return static_cast<size_t>(hash(r));
+		}
+	};
+
+	struct range_equal {
+		using is_transparent = void;
+
+		template <typename A, typename B>
+		bool operator() (A const& a, B const& b) const {
+			return range(a) == range(b);
+		}
+	};
+}
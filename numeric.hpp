@@ -0,0 +1,131 @@
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+#include "ranger.hpp"
+
+#if defined(__SSE2__) and defined(__x86_64__)
+#include <emmintrin.h>
+#define RANGER_SSE2
+#endif
+
+namespace __ranger {
+	template <typename I>
+	constexpr bool is_integer_pointer (size_t const size) {
+		if constexpr(std::is_pointer_v<I>) {
+			using T = std::remove_cv_t<std::remove_pointer_t<I>>;
+			return std::is_integral_v<T> and not std::is_same_v<T, bool> and sizeof(T) == size;
+		}
+
+		return false;
+	}
+
+	// in place prefix sums from `sum`,  inclusive (x[i] = sum + x[0] + .. + x[i]) or exclusive (.. + x[i - 1])
+	// returns the sum of all elements (plus `sum`)
+	template <bool Inclusive, typename I, typename T>
+	T scan (I const begin, I const end, T sum) {
+		auto p = begin;
+
+#ifdef RANGER_SSE2
+		if constexpr(is_integer_pointer<I>(4)) {
+			auto carry = _mm_set1_epi32(static_cast<int32_t>(sum));
+
+			for (; end - p >= 4; p += 4) {
+				auto const v = _mm_loadu_si128(reinterpret_cast<__m128i const*>(p));
+				auto x = _mm_add_epi32(v, _mm_slli_si128(v, 4));
+				x = _mm_add_epi32(x, _mm_slli_si128(x, 8));
+				x = _mm_add_epi32(x, carry);
+
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(p), Inclusive ? x : _mm_sub_epi32(x, v));
+				carry = _mm_shuffle_epi32(x, 0xff);
+			}
+
+			sum = static_cast<T>(_mm_cvtsi128_si32(carry));
+		} else if constexpr(is_integer_pointer<I>(8)) {
+			auto carry = _mm_set1_epi64x(static_cast<int64_t>(sum));
+
+			for (; end - p >= 2; p += 2) {
+				auto const v = _mm_loadu_si128(reinterpret_cast<__m128i const*>(p));
+				auto x = _mm_add_epi64(v, _mm_slli_si128(v, 8));
+				x = _mm_add_epi64(x, carry);
+
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(p), Inclusive ? x : _mm_sub_epi64(x, v));
+				carry = _mm_unpackhi_epi64(x, x);
+			}
+
+			sum = static_cast<T>(_mm_cvtsi128_si64(carry));
+		}
+#endif
+
+		for (; p != end; ++p) {
+			auto const x = *p;
+			sum = static_cast<T>(sum + x);
+			*p = Inclusive ? sum : static_cast<T>(sum - x);
+		}
+
+		return sum;
+	}
+}
+
+namespace ranger {
+	// containers with data() are scanned through pointers,  for the SSE2 kernels
+	template <typename R>
+	auto inclusive_scan (R&& r, typename decltype(range(r))::value_type const init = 0) {
+		auto const a = contiguous_range(r);
+		return __ranger::scan<true>(a.begin(), a.end(), init);
+	}
+
+	template <typename R>
+	auto exclusive_scan (R&& r, typename decltype(range(r))::value_type const init = 0) {
+		auto const a = contiguous_range(r);
+		return __ranger::scan<false>(a.begin(), a.end(), init);
+	}
+
+	// in place x[i] = x[i] - x[i - 1],  with x[-1] = `init`
+	template <typename R>
+	void delta (R&& r, typename decltype(range(r))::value_type const init = 0) {
+		auto const a = range(r);
+		using T = typename decltype(a)::value_type;
+
+		auto previous = init;
+		for (auto& x : a) {
+			auto const current = x;
+			x = static_cast<T>(current - previous);
+			previous = current;
+		}
+	}
+
+	// the inverse of delta,  an inclusive scan from `init`
+	template <typename R>
+	void undelta (R&& r, typename decltype(range(r))::value_type const init = 0) {
+		ranger::inclusive_scan(r, init);
+	}
+
+	// maps signed integers to unsigned,  small magnitudes to small values (0, -1, 1, -2 -> 0, 1, 2, 3)
+	template <typename T>
+	constexpr auto zigzag_encode (T const x) {
+		using U = std::make_unsigned_t<T>;
+		return static_cast<U>((static_cast<U>(x) << 1) ^ static_cast<U>(x < 0 ? ~U(0) : U(0)));
+	}
+
+	template <typename U>
+	constexpr auto zigzag_decode (U const u) {
+		using T = std::make_signed_t<U>;
+		return static_cast<T>(static_cast<U>((u >> 1) ^ static_cast<U>(U(0) - (u & 1))));
+	}
+
+	// in place zigzag_encode/zigzag_decode,  keeping the element type (the bits are reinterpreted)
+	template <typename R>
+	void zigzag (R&& r) {
+		using T = typename decltype(range(r))::value_type;
+		using S = std::make_signed_t<T>;
+		for (auto& x : range(r)) x = static_cast<T>(zigzag_encode(static_cast<S>(x)));
+	}
+
+	template <typename R>
+	void unzigzag (R&& r) {
+		using T = typename decltype(range(r))::value_type;
+		using U = std::make_unsigned_t<T>;
+		for (auto& x : range(r)) x = static_cast<T>(zigzag_decode(static_cast<U>(x)));
+	}
+}
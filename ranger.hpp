@@ -2,33 +2,133 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
 #include <iterator>
+#include <memory>
 #include <type_traits>
+#include <utility>
+
+#ifdef RANGER_STATS
+#include <cstddef>
+#include <ostream>
 
 namespace __ranger {
-	template <typename I>
+	// per-thread operation counters,  only compiled in with RANGER_STATS
+	struct Stats {
+		struct Counter {
+			size_t calls = 0; // one per call (a range put is one call)
+			size_t elements = 0; // elements walked (non random access advances,  search positions) or copied
+			size_t bytes = 0; // bytes copied
+		};
+
+		Counter pop_front;
+		Counter pop_back;
+		Counter contains;
+		Counter put;
+		Counter serial_read;
+		Counter serial_put;
+	};
+
+	inline Stats& stats () {
+		thread_local Stats s;
+		return s;
+	}
+}
+
+// not counted in constant expressions
+#define RANGER_STAT(counter, n, b) do { \
+	if (__builtin_is_constant_evaluated()) break; \
+	auto& __c = __ranger::stats().counter; \
+	__c.calls += 1; \
+	__c.elements += static_cast<size_t>(n); \
+	__c.bytes += static_cast<size_t>(b); \
+} while (0)
+#else
+#define RANGER_STAT(counter, n, b) do { (void) (n); (void) (b); } while (0)
+#endif
+
+namespace __ranger {
+	// bounds policies
+	// Unchecked: no checks,  out of bounds is undefined behaviour
+	// Clamping: pop_*/drop/take clamp to the range,  accessors only assert (the default)
+	// Trapping: any out of bounds access or advance traps
+	struct Unchecked {
+		static constexpr bool clamp = false;
+		static constexpr bool trap = false;
+	};
+
+	struct Clamping {
+		static constexpr bool clamp = true;
+		static constexpr bool trap = false;
+	};
+
+	struct Trapping {
+		static constexpr bool clamp = false;
+		static constexpr bool trap = true;
+	};
+
+	[[noreturn]] inline void trap () {
+#if defined(__GNUC__) || defined(__clang__)
+		__builtin_trap();
+#else
+		std::abort();
+#endif
+	}
+
+	template <typename P>
+	constexpr void require (bool const condition) {
+		if constexpr(P::trap) {
+			if (not condition) trap();
+		} else if constexpr(P::clamp) {
+			assert(condition);
+		}
+
+		(void) condition;
+	}
+
+	template <typename I, typename P = Clamping>
 	struct Range;
 
 	template <typename I, typename R = Range<I>, bool Condition = R::is_forward::value>
-	typename std::conditional_t<Condition, R, void>
+	constexpr typename std::conditional_t<Condition, R, void>
 	pop_front (R& a, size_t const un) {
-		auto const n = static_cast<typename R::distance_type>(un);
+		using P = typename R::policy;
+
+		auto n = static_cast<typename R::distance_type>(un);
 		if constexpr(std::is_signed<typename R::distance_type>::value) {
 			assert(n >= 0);
 		}
 
+		RANGER_STAT(pop_front, R::is_random_access::value ? 0 : un, 0);
+
 		if constexpr(not R::is_forward::value) {
 			if (a.empty()) return;
 			std::advance(a._begin, n);
 			return;
 		} else {
-			if (a.empty()) return a;
 			auto it = a._begin;
-			std::advance(a._begin, n);
+
 			if constexpr(R::is_random_access::value) {
-				if (a._begin > a._end) {
-					a._begin = a._end;
+				auto const size = std::distance(a._begin, a._end);
+				if constexpr(P::trap) {
+					if (n > size) trap();
+				} else if constexpr(P::clamp) {
+					n = std::min(n, size);
 				}
+
+				std::advance(a._begin, n);
+			} else if constexpr(P::trap) {
+				for (; n > 0; --n) {
+					if (a._begin == a._end) trap();
+					++a._begin;
+				}
+			} else if constexpr(P::clamp) {
+				for (; n > 0 and a._begin != a._end; --n) ++a._begin;
+			} else {
+				std::advance(a._begin, n);
 			}
 
 			return R(it, a._begin);
@@ -36,25 +136,42 @@ namespace __ranger {
 	}
 
 	template <typename I, typename R = Range<I>, bool Condition = R::is_bidirectional::value>
-	typename std::conditional_t<Condition, R, void>
+	constexpr typename std::conditional_t<Condition, R, void>
 	pop_back (R& a, size_t const un) {
-		auto const n = static_cast<typename R::distance_type>(un);
+		using P = typename R::policy;
+
+		auto n = static_cast<typename R::distance_type>(un);
 		if constexpr(std::is_signed<typename R::distance_type>::value) {
 			assert(n >= 0);
 		}
 
+		RANGER_STAT(pop_back, R::is_random_access::value ? 0 : un, 0);
+
 		if constexpr(not R::is_forward::value) {
 			if (a.empty()) return;
 			std::advance(a._end, -n);
 			return;
 		} else {
-			if (a.empty()) return a;
 			auto it = a._end;
-			std::advance(a._end, -n);
+
 			if constexpr(R::is_random_access::value) {
-				if (a._end < a._begin) {
-					a._end = a._begin;
+				auto const size = std::distance(a._begin, a._end);
+				if constexpr(P::trap) {
+					if (n > size) trap();
+				} else if constexpr(P::clamp) {
+					n = std::min(n, size);
 				}
+
+				std::advance(a._end, -n);
+			} else if constexpr(P::trap) {
+				for (; n > 0; --n) {
+					if (a._begin == a._end) trap();
+					--a._end;
+				}
+			} else if constexpr(P::clamp) {
+				for (; n > 0 and a._begin != a._end; --n) --a._end;
+			} else {
+				std::advance(a._end, -n);
 			}
 
 			return R(a._end, it);
@@ -62,7 +179,7 @@ namespace __ranger {
 	}
 
 	template <typename I, typename R = Range<I>, typename F>
-	auto pop_until (R& a, F const f) {
+	constexpr auto pop_until (R& a, F const f) {
 		if constexpr(not R::is_forward::value) {
 			while (not a.empty()) {
 				if (f(a.front())) break;
@@ -81,7 +198,7 @@ namespace __ranger {
 	}
 
 	template <typename I, typename R = Range<I>, typename F>
-	auto pop_back_until (R& a, F const f) {
+	constexpr auto pop_back_until (R& a, F const f) {
 		if constexpr(not R::is_forward::value) {
 			while (not a.empty()) {
 				if (f(a.back())) break;
@@ -99,38 +216,105 @@ namespace __ranger {
 		}
 	}
 
-	template <typename I>
-	auto put (Range<I>& a, typename Range<I>::value_type v) {
+	template <typename I, typename P>
+	constexpr auto put (Range<I, P>& a, typename Range<I, P>::value_type v) {
 		if (a.empty()) return false;
+		RANGER_STAT(put, 1, sizeof(v));
 		a.front() = v;
 		a.pop_front();
 		return true;
 	}
 
-	template <typename A, typename B>
-	auto put (Range<A>& a, Range<B> b) {
-		while (not b.empty()) {
-			if (a.empty()) return false;
-			a.front() = b.front();
-			a.pop_front();
-			b.pop_front();
+	template <typename A, typename PA, typename B, typename PB>
+	constexpr auto put (Range<A, PA>& a, Range<B, PB> b) {
+		// in bulk,  a memmove for pointers to trivially copyable elements
+		if constexpr(Range<A, PA>::is_random_access::value and Range<B, PB>::is_random_access::value) {
+			auto const n = std::min(a.size(), b.size());
+			std::copy_n(b.begin(), n, a.begin());
+			a.pop_front(n);
+			b.pop_front(n);
+
+			RANGER_STAT(put, n, n * sizeof(typename Range<A, PA>::value_type));
+			return b.empty();
+		} else {
+			size_t n = 0;
+			for (; not b.empty() and not a.empty(); ++n) {
+				a.front() = b.front();
+				a.pop_front();
+				b.pop_front();
+			}
+
+			RANGER_STAT(put, n, n * sizeof(typename Range<A, PA>::value_type));
+			return b.empty();
 		}
+	}
 
-		return true;
+	template <typename S>
+	struct ChainRange;
+
+	// a segment at a time
+	template <typename A, typename PA, typename S>
+	constexpr auto put (Range<A, PA>& a, ChainRange<S> const b) {
+		return b.each_segment([&](auto const segment) {
+			return __ranger::put(a, segment);
+		});
+	}
+
+	template <typename I>
+	constexpr bool is_byte_pointer () {
+		if constexpr(std::is_pointer_v<I>) {
+			using T = std::remove_cv_t<std::remove_pointer_t<I>>;
+			return sizeof(T) == 1 and std::is_integral_v<T> and not std::is_same_v<T, bool>;
+		}
+
+		return false;
 	}
 
-	template <typename A, typename B>
-	bool contains (Range<A> a, Range<B> const b) {
-		while (not a.empty()) {
-			if (a.starts_with(b)) return true;
-			a.pop_front();
+	// the start of the first occurrence of `b` in `a`,  or `a.end()`
+	// for byte pointers of the same type,  memchr for the first byte then memcmp for the rest
+	template <typename A, typename PA, typename B, typename PB>
+	constexpr A find (Range<A, PA> a, Range<B, PB> const b) {
+		if constexpr(is_byte_pointer<A>() and std::is_same_v<std::remove_cv_t<std::remove_pointer_t<A>>, std::remove_cv_t<std::remove_pointer_t<B>>>) {
+			if (not __builtin_is_constant_evaluated()) {
+				auto const begin = a.begin();
+				auto const end = a.end();
+				auto const m = b.size();
+				auto result = m == 0 ? begin : end;
+
+				auto p = begin;
+				auto const first = m == 0 ? uint8_t(0) : static_cast<uint8_t>(b.front());
+				while (m != 0 and static_cast<size_t>(end - p) >= m) {
+					auto const found = std::memchr(p, first, static_cast<size_t>(end - p) - m + 1);
+					if (not found) break;
+
+					p = static_cast<A>(found);
+					if (std::memcmp(p + 1, b.begin() + 1, m - 1) == 0) {
+						result = p;
+						break;
+					}
+
+					++p;
+				}
+
+				RANGER_STAT(contains, result - begin, 0);
+				return result;
+			}
 		}
 
-		return false;;
+		size_t n = 0;
+		for (; not a.empty() and not a.starts_with(b); ++n) a.pop_front();
+
+		RANGER_STAT(contains, n, 0);
+		return a.begin();
+	}
+
+	template <typename A, typename PA, typename B, typename PB>
+	constexpr bool contains (Range<A, PA> const a, Range<B, PB> const b) {
+		return __ranger::find(a, b) != a.end();
 	}
 
-	template <typename A, typename B>
-	bool starts_with (Range<A> a, Range<B> b) {
+	template <typename A, typename PA, typename B, typename PB>
+	constexpr bool starts_with (Range<A, PA> a, Range<B, PB> b) {
 		while (not (a.empty() or b.empty())) {
 			if (a.front() == b.front()) {
 				a.pop_front();
@@ -144,8 +328,8 @@ namespace __ranger {
 		return b.empty();
 	}
 
-	template <typename A, typename B>
-	bool ends_with (Range<A> a, Range<B> b) {
+	template <typename A, typename PA, typename B, typename PB>
+	constexpr bool ends_with (Range<A, PA> a, Range<B, PB> b) {
 		while (not (a.empty() or b.empty())) {
 			if (a.back() == b.back()) {
 				a.pop_back();
@@ -159,12 +343,113 @@ namespace __ranger {
 		return b.empty();
 	}
 
-	template <typename I>
+	template <typename A, typename PA, typename B, typename PB, typename F>
+	constexpr auto top_k (Range<A, PA> const a, size_t const k, Range<B, PB> const out, F const f) {
+		static_assert(Range<B, PB>::is_random_access::value, "Expected random access output");
+
+		auto const o = out.take(k);
+		return Range<B, PB>(o.begin(), std::partial_sort_copy(a.begin(), a.end(), o.begin(), o.end(), f));
+	}
+
+	template <typename I, typename P, typename F>
+	constexpr auto nth (Range<I, P> const a, size_t const k, F const f) {
+		auto const left = a.take(k);
+		auto const right = a.drop(k);
+		if (not right.empty()) std::nth_element(a.begin(), right.begin(), a.end(), f);
+
+		return std::make_pair(left, right);
+	}
+
+	// summation modes
+	// Fast: multiple independent accumulators (reassociates,  but vectorizes without -ffast-math)
+	// Kahan: compensated (Neumaier) summation,  for floating point accuracy
+	// Pairwise: recursive halving over Fast blocks,  O(log n) error growth at near Fast speed
+	struct Fast {};
+	struct Kahan {};
+	struct Pairwise {};
+
+	template <typename R>
+	using sum_t = decltype(std::declval<typename R::value_type>() + std::declval<typename R::value_type>());
+
+	template <typename I, typename P>
+	constexpr auto sum (Range<I, P> const a, Fast) {
+		using T = sum_t<Range<I, P>>;
+
+		if constexpr(Range<I, P>::is_random_access::value) {
+			constexpr size_t lanes = 8;
+
+			T acc[lanes] = {};
+			auto const n = a.size();
+			auto const p = a.begin();
+			size_t i = 0;
+
+			for (; i + lanes <= n; i += lanes) {
+				for (size_t j = 0; j < lanes; ++j) {
+					acc[j] += p[static_cast<typename Range<I, P>::distance_type>(i + j)];
+				}
+			}
+
+			for (; i < n; ++i) acc[0] += p[static_cast<typename Range<I, P>::distance_type>(i)];
+			return ((acc[0] + acc[1]) + (acc[2] + acc[3])) + ((acc[4] + acc[5]) + (acc[6] + acc[7]));
+		} else {
+			auto result = T();
+			for (auto const& x : a) result += x;
+			return result;
+		}
+	}
+
+	template <typename I, typename P>
+	constexpr auto sum (Range<I, P> const a, Kahan) {
+		using T = sum_t<Range<I, P>>;
+
+		auto result = T();
+		auto compensation = T();
+
+		for (auto const& x : a) {
+			auto const t = result + x;
+			if ((result < 0 ? -result : result) >= (x < 0 ? -x : x)) {
+				compensation += (result - t) + x;
+			} else {
+				compensation += (x - t) + result;
+			}
+
+			result = t;
+		}
+
+		return result + compensation;
+	}
+
+	template <typename I, typename P>
+	constexpr auto sum (Range<I, P> const a, Pairwise) {
+		static_assert(Range<I, P>::is_random_access::value, "Expected random access");
+
+		auto const n = a.size();
+		if (n <= 128) return sum(a, Fast());
+
+		auto const half = n / 2;
+		return sum(a.take(half), Pairwise()) + sum(a.drop(half), Pairwise());
+	}
+
+	// the first minimum/maximum,  by `f`
+	template <typename I, typename P, typename F>
+	constexpr auto min_element (Range<I, P> const a, F const f) {
+		require<P>(not a.empty());
+
+		auto result = a.begin();
+		for (auto it = std::next(result); it != a.end(); ++it) {
+			if (f(*it, *result)) result = it;
+		}
+
+		return result;
+	}
+
+	template <typename I, typename P>
 	struct Range {
 		I _begin;
 		I _end;
 
 		using iterator = I;
+		using policy = P;
 		using value_type = typename std::remove_const_t<
 			typename std::remove_reference_t<decltype(*I())>
 		>;
@@ -175,24 +460,24 @@ namespace __ranger {
 		using is_input = std::is_base_of<std::input_iterator_tag, iterator_category>;
 		using is_random_access = std::is_base_of<std::random_access_iterator_tag, iterator_category>;
 
-		Range (I begin, I end) : _begin(begin), _end(end) {
+		constexpr Range (I begin, I end) : _begin(begin), _end(end) {
 			if constexpr(is_random_access::value) {
-				assert(end >= begin);
+				require<P>(end >= begin);
 			}
 		}
 
-		auto begin () const { return this->_begin; }
-		auto end () const { return this->_end; }
-		auto empty () const { return this->begin() == this->end(); }
+		constexpr auto begin () const { return this->_begin; }
+		constexpr auto end () const { return this->_end; }
+		constexpr auto empty () const { return this->begin() == this->end(); }
 
 		template <bool Condition = std::is_pointer_v<I>>
-		typename std::enable_if_t<Condition, I>
+		constexpr typename std::enable_if_t<Condition, I>
 		data () const {
 			return this->begin();
 		}
 
 		template <bool Condition = is_forward::value>
-		typename std::enable_if_t<Condition, Range>
+		constexpr typename std::enable_if_t<Condition, Range>
 		drop (size_t const un) const {
 			auto copy = *this;
 			copy.pop_front(un);
@@ -200,7 +485,7 @@ namespace __ranger {
 		}
 
 		template <typename F, bool Condition = is_forward::value>
-		typename std::enable_if_t<Condition, Range>
+		constexpr typename std::enable_if_t<Condition, Range>
 		drop_until (F const f) const {
 			auto copy = *this;
 			copy.pop_until(f);
@@ -208,7 +493,7 @@ namespace __ranger {
 		}
 
 		template <bool Condition = is_bidirectional::value>
-		typename std::enable_if_t<Condition, Range>
+		constexpr typename std::enable_if_t<Condition, Range>
 		drop_back (size_t const un) const {
 			auto copy = *this;
 			copy.pop_back(un);
@@ -216,102 +501,111 @@ namespace __ranger {
 		}
 
 		template <typename F, bool Condition = is_bidirectional::value>
-		typename std::enable_if_t<Condition, Range>
+		constexpr typename std::enable_if_t<Condition, Range>
 		drop_back_until (F const f) const {
 			auto copy = *this;
 			copy.pop_back_until(f);
 			return copy;
 		}
 
-		auto drop_unto (Range const b) const {
+		constexpr auto drop_unto (Range const b) const {
 			if (b.begin() < this->begin()) return *this;
 			if (b.begin() > this->end()) return Range(this->end(), this->end());
 			return Range(b.begin(), this->end());
 		}
 
-		auto drop_back_unto (Range const b) const {
+		constexpr auto drop_back_unto (Range const b) const {
 			if (b.end() > this->end()) return *this;
 			if (b.end() < this->begin()) return Range(this->begin(), this->begin());
 			return Range(this->begin(), b.end());
 		}
 
-		auto take (size_t const un) const {
+		constexpr auto take (size_t const un) const {
 			return Range(this->begin(), this->drop(un).begin());
 		}
 
 		template <typename F>
-		auto take_until (F const f) const {
+		constexpr auto take_until (F const f) const {
 			return Range(this->begin(), this->drop_until(f).begin());
 		}
 
-		auto take_back (size_t const un) const {
+		constexpr auto take_back (size_t const un) const {
 			return Range(this->drop_back(un).end(), this->end());
 		}
 
 		template <typename F>
-		auto take_back_until (F const f) const {
+		constexpr auto take_back_until (F const f) const {
 			return Range(this->drop_back_until(f).end(), this->end());
 		}
 
-		auto& front () {
-			assert(not this->empty());
-			return *this->begin();
+		// dereferences the member,  not a temporary copy (which an input iterator may hold the value in)
+		constexpr decltype(auto) front () {
+			require<P>(not this->empty());
+			return *this->_begin;
 		}
 
-		auto& front () const {
-			assert(not this->empty());
-			return *this->begin();
+		constexpr decltype(auto) front () const {
+			require<P>(not this->empty());
+			return *this->_begin;
 		}
 
-		auto& back () {
-			return this->take_back(1).front();
+		template <bool Condition = is_bidirectional::value>
+		constexpr typename std::enable_if_t<Condition, decltype(*I())>
+		back () {
+			require<P>(not this->empty());
+			return *std::prev(this->end());
 		}
 
-		auto& back () const {
-			return this->take_back(1).front();
+		template <bool Condition = is_bidirectional::value>
+		constexpr typename std::enable_if_t<Condition, decltype(*I())>
+		back () const {
+			require<P>(not this->empty());
+			return *std::prev(this->end());
 		}
 
 		template <bool Condition = is_random_access::value>
-		typename std::enable_if_t<Condition, size_t>
+		constexpr typename std::enable_if_t<Condition, size_t>
 		size () const {
 			assert(this->end() >= this->begin());
 			return static_cast<size_t>(std::distance(this->begin(), this->end()));
 		}
 
 		template <bool Condition = is_random_access::value>
-		typename std::enable_if_t<Condition, value_type&>
+		constexpr typename std::enable_if_t<Condition, decltype(*I())>
 		operator[] (size_t const i) {
-			return this->drop(i).front();
+			require<P>(i < this->size());
+			return this->begin()[static_cast<distance_type>(i)];
 		}
 
 		template <bool Condition = is_random_access::value>
-		typename std::enable_if_t<Condition, value_type>
+		constexpr typename std::enable_if_t<Condition, value_type>
 		operator[] (size_t const i) const {
-			return this->drop(i).front();
+			require<P>(i < this->size());
+			return this->begin()[static_cast<distance_type>(i)];
 		}
 
 		template <typename B>
-		bool operator< (B const& b) const {
+		constexpr bool operator< (B const& b) const {
 			return std::lexicographical_compare(this->begin(), this->end(), b.begin(), b.end());
 		}
 
 		template <typename B>
-		bool operator> (B const& b) const {
+		constexpr bool operator> (B const& b) const {
 			return std::lexicographical_compare(b.begin(), b.end(), this->begin(), this->end());
 		}
 
 		template <typename B>
-		bool operator== (B const& b) const {
+		constexpr bool operator== (B const& b) const {
 			return std::equal(this->begin(), this->end(), b.begin(), b.end());
 		}
 
 		template <typename B>
-		bool operator!= (B const& b) const {
+		constexpr bool operator!= (B const& b) const {
 			return not std::equal(this->begin(), this->end(), b.begin(), b.end());
 		}
 
 		template <typename F>
-		bool any (F const f) const {
+		constexpr bool any (F const f) const {
 			for (auto x : *this) {
 				if (f(x)) return true;
 			}
@@ -320,7 +614,7 @@ namespace __ranger {
 		}
 
 		template <typename F>
-		bool all (F const f) const {
+		constexpr bool all (F const f) const {
 			for (auto x : *this) {
 				if (not f(x)) return false;
 			}
@@ -329,22 +623,22 @@ namespace __ranger {
 		}
 
 		template <typename B>
-		bool contains (B const& b) const {
+		constexpr bool contains (B const& b) const {
 			return __ranger::contains(*this, b);
 		}
 
 		template <typename B>
-		bool starts_with (B const& b) const {
+		constexpr bool starts_with (B const& b) const {
 			return __ranger::starts_with(*this, b);
 		}
 
 		template <typename B>
-		bool ends_with (B const& b) const {
+		constexpr bool ends_with (B const& b) const {
 			return __ranger::ends_with(*this, b);
 		}
 
 		template <typename F>
-		size_t count (F const f) const {
+		constexpr size_t count (F const f) const {
 			size_t result = 0;
 
 			for (auto x : *this) {
@@ -354,102 +648,975 @@ namespace __ranger {
 			return result;
 		}
 
+		// reductions,  see __ranger::Fast/Kahan/Pairwise for the summation modes
+		template <typename M = __ranger::Fast>
+		constexpr auto sum (M const m = M()) const {
+			return __ranger::sum(*this, m);
+		}
+
+		constexpr auto min () const {
+			return *__ranger::min_element(*this, std::less<>());
+		}
+
+		constexpr auto max () const {
+			return *__ranger::min_element(*this, std::greater<>());
+		}
+
+		constexpr auto minmax () const {
+			require<P>(not this->empty());
+
+			auto lo = this->front();
+			auto hi = lo;
+			for (auto const& x : *this) {
+				if (x < lo) lo = x;
+				if (hi < x) hi = x;
+			}
+
+			return std::make_pair(lo, hi);
+		}
+
+		// the index of the first minimum/maximum
+		constexpr auto argmin () const {
+			return static_cast<size_t>(std::distance(this->begin(), __ranger::min_element(*this, std::less<>())));
+		}
+
+		constexpr auto argmax () const {
+			return static_cast<size_t>(std::distance(this->begin(), __ranger::min_element(*this, std::greater<>())));
+		}
+
+		// writes the `k` first elements (as ordered by `f`) to `out`, in order
+		template <typename B, typename PB, typename F = std::less<>>
+		constexpr auto top_k (size_t const k, Range<B, PB> const out, F const f = F()) const {
+			return __ranger::top_k(*this, k, out, f);
+		}
+
+		// partially orders the range so that [0, k) <= [k] <= (k, n),  returns {[0, k), [k, n)}
+		template <typename F = std::less<>, bool Condition = is_random_access::value>
+		constexpr typename std::enable_if_t<Condition, std::pair<Range, Range>>
+		nth (size_t const k, F const f = F()) const {
+			return __ranger::nth(*this, k, f);
+		}
+
 		// mutators
-		auto pop_back () {
-			return __ranger::pop_back<I>(*this, 1);
+		template <bool Condition = is_bidirectional::value>
+		constexpr typename std::enable_if_t<Condition, Range>
+		pop_back () {
+			return __ranger::pop_back<I, Range>(*this, 1);
+		}
+
+		template <bool Condition = is_bidirectional::value>
+		constexpr typename std::enable_if_t<Condition, Range>
+		pop_back (size_t const un) {
+			return __ranger::pop_back<I, Range>(*this, un);
+		}
+
+		constexpr auto pop_front () {
+			return __ranger::pop_front<I, Range>(*this, 1);
+		}
+
+		constexpr auto pop_front (size_t const un) {
+			return __ranger::pop_front<I, Range>(*this, un);
+		}
+
+		template <typename F>
+		constexpr auto pop_until (F const f) {
+			return __ranger::pop_until<I, Range>(*this, f);
+		}
+
+		template <typename F>
+		constexpr auto pop_back_until (F const f) {
+			return __ranger::pop_back_until<I, Range>(*this, f);
+		}
+
+		template <typename E>
+		constexpr auto put (E const e) { return __ranger::put(*this, e); }
+	};
+
+	// an iterator that carries the number of elements remaining until the end of its range,
+	// equality is by that count,  so an end iterator needs no underlying position
+	template <typename I>
+	struct CountedIterator {
+		using iterator_category = typename std::conditional_t<
+			std::is_base_of<std::forward_iterator_tag, typename std::iterator_traits<I>::iterator_category>::value,
+			std::forward_iterator_tag,
+			std::input_iterator_tag
+		>;
+		using value_type = typename std::iterator_traits<I>::value_type;
+		using difference_type = typename std::iterator_traits<I>::difference_type;
+		using pointer = typename std::iterator_traits<I>::pointer;
+		using reference = typename std::iterator_traits<I>::reference;
+
+		I _it;
+		difference_type _n;
+
+		constexpr CountedIterator () : _it(), _n(0) {}
+		constexpr CountedIterator (I it, difference_type n) : _it(it), _n(n) {}
+
+		constexpr auto base () const { return this->_it; }
+		constexpr auto count () const { return this->_n; }
+
+		constexpr reference operator* () const { return *this->_it; }
+
+		constexpr auto& operator++ () {
+			++this->_it;
+			--this->_n;
+			return *this;
+		}
+
+		constexpr auto operator++ (int) {
+			auto copy = *this;
+			++*this;
+			return copy;
+		}
+
+		constexpr bool operator== (CountedIterator const& b) const { return this->_n == b._n; }
+		constexpr bool operator!= (CountedIterator const& b) const { return this->_n != b._n; }
+	};
+
+	// a range with a cached element count,  for iterators without random access
+	// size, empty and take are O(1),  drop only walks the dropped elements
+	// forward only,  the end carries no position (so no back, pop_back or the like)
+	template <typename I>
+	struct SizedRange : public Range<CountedIterator<I>> {
+		using iterator = CountedIterator<I>;
+
+		constexpr SizedRange (iterator begin, iterator end) : Range<iterator>(begin, end) {}
+		constexpr SizedRange (I begin, size_t const n) : Range<iterator>(
+			iterator(begin, static_cast<typename iterator::difference_type>(n)),
+			iterator()
+		) {}
+
+		constexpr auto size () const {
+			return static_cast<size_t>(this->begin().count() - this->end().count());
+		}
+
+		constexpr auto drop (size_t const un) const {
+			auto copy = *this;
+			copy.pop_front(un);
+			return copy;
+		}
+
+		constexpr auto take (size_t const un) const {
+			auto const n = static_cast<typename iterator::difference_type>(std::min(un, this->size()));
+			return SizedRange(this->begin(), iterator(I(), this->begin().count() - n));
+		}
+
+		constexpr auto pop_front () {
+			return this->pop_front(1);
+		}
+
+		constexpr auto pop_front (size_t const un) {
+			auto const r = __ranger::pop_front<iterator>(*this, std::min(un, this->size()));
+			return SizedRange(r.begin(), r.end());
+		}
+	};
+
+	// what PrefetchIterator prefetches,  given the element `_distance` ahead
+	// the element itself
+	struct Address {
+		template <typename T>
+		constexpr void const* operator() (T const& x) const { return std::addressof(x); }
+	};
+
+	// the pointee of a pointer element
+	struct Pointee {
+		template <typename T>
+		constexpr void const* operator() (T const* const x) const { return x; }
+	};
+
+	// the element of `_base` at an index element
+	template <typename T>
+	struct Indexed {
+		T const* _base;
+
+		template <typename U>
+		constexpr void const* operator() (U const i) const { return this->_base + i; }
+	};
+
+	// an iterator that prefetches `_f(_it[_distance])`,  never past `_end`
+	// random access only,  a node based iterator would have to load each node to find the next one,
+	// gathers (pointers,  or indices into an array) are where it pays,  the hardware prefetches sequential walks
+	template <typename I, typename F = Address>
+	struct PrefetchIterator {
+		using iterator_category = typename std::iterator_traits<I>::iterator_category;
+		using value_type = typename std::iterator_traits<I>::value_type;
+		using difference_type = typename std::iterator_traits<I>::difference_type;
+		using pointer = typename std::iterator_traits<I>::pointer;
+		using reference = typename std::iterator_traits<I>::reference;
+
+		static_assert(std::is_base_of<std::random_access_iterator_tag, iterator_category>::value, "Expected a random access iterator");
+
+		I _it;
+		I _end;
+		difference_type _distance;
+		F _f;
+
+		constexpr PrefetchIterator () : _it(), _end(), _distance(0), _f() {}
+		constexpr PrefetchIterator (I it, I end, difference_type distance, F f = F()) : _it(it), _end(end), _distance(distance), _f(f) {}
+
+		constexpr auto base () const { return this->_it; }
+
+		// advances,  then prefetches ahead (not in constant expressions,  nor for elements without an address)
+		// one function with the store,  a separate const one would be inferred pure and its calls dropped (GCC)
+		constexpr void advance (difference_type const n) {
+			this->_it += n;
+
+			if constexpr(std::is_reference_v<reference> or not std::is_same_v<F, Address>) {
+				if (__builtin_is_constant_evaluated()) return;
+				if (this->_end - this->_it <= this->_distance) return;
+#if defined(__GNUC__) || defined(__clang__)
+				__builtin_prefetch(this->_f(this->_it[this->_distance]));
+#endif
+			}
+		}
+
+		constexpr reference operator* () const { return *this->_it; }
+		constexpr pointer operator-> () const { return std::addressof(*this->_it); }
+
+		constexpr auto& operator++ () {
+			this->advance(1);
+			return *this;
+		}
+
+		constexpr auto operator++ (int) {
+			auto copy = *this;
+			++*this;
+			return copy;
+		}
+
+		constexpr auto& operator-- () {
+			--this->_it;
+			return *this;
+		}
+
+		constexpr auto operator-- (int) {
+			auto copy = *this;
+			--*this;
+			return copy;
+		}
+
+		constexpr auto& operator+= (difference_type const n) {
+			this->advance(n);
+			return *this;
+		}
+
+		constexpr auto& operator-= (difference_type const n) {
+			this->_it -= n;
+			return *this;
+		}
+
+		constexpr auto operator+ (difference_type const n) const { auto copy = *this; return copy += n; }
+		constexpr auto operator- (difference_type const n) const { auto copy = *this; return copy -= n; }
+		friend constexpr auto operator+ (difference_type const n, PrefetchIterator const& it) { return it + n; }
+
+		constexpr difference_type operator- (PrefetchIterator const& b) const { return this->_it - b._it; }
+		constexpr reference operator[] (difference_type const n) const { return this->_it[n]; }
+
+		constexpr bool operator== (PrefetchIterator const& b) const { return this->_it == b._it; }
+		constexpr bool operator!= (PrefetchIterator const& b) const { return this->_it != b._it; }
+		constexpr bool operator< (PrefetchIterator const& b) const { return this->_it < b._it; }
+		constexpr bool operator> (PrefetchIterator const& b) const { return this->_it > b._it; }
+		constexpr bool operator<= (PrefetchIterator const& b) const { return this->_it <= b._it; }
+		constexpr bool operator>= (PrefetchIterator const& b) const { return this->_it >= b._it; }
+	};
+
+	template <typename R, typename = void>
+	struct has_size : std::false_type {};
+
+	template <typename R>
+	struct has_size<R, std::void_t<decltype(std::declval<R&>().size())>> : std::true_type {};
+
+	template <typename R, typename = void>
+	struct has_data : std::false_type {};
+
+	template <typename R>
+	struct has_data<R, std::void_t<decltype(std::declval<R&>().data() + std::declval<R&>().size())>> : std::true_type {};
+
+	template <typename R>
+	constexpr auto as_range (R const& r) {
+		return Range<decltype(std::begin(r))>(std::begin(r), std::end(r));
+	}
+
+	// as_range(r),  but as a pointer range if `r` has data(),  for the memchr fast path
+	template <typename R>
+	constexpr auto as_contiguous_range (R const& r) {
+		if constexpr(has_data<R const>::value) {
+			return Range<decltype(r.data())>(r.data(), r.data() + r.size());
+		} else {
+			return as_range(r);
+		}
+	}
+
+	// an iterator over the elements of a sequence of segments (ranges),  e.g. a list of buffers
+	// it never rests at the end of a segment,  unless at the end of all segments
+	template <typename S>
+	struct ChainIterator {
+		using segment_iterator = decltype(std::begin(*std::declval<S>()));
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = typename std::iterator_traits<segment_iterator>::value_type;
+		using difference_type = typename std::iterator_traits<segment_iterator>::difference_type;
+		using pointer = typename std::iterator_traits<segment_iterator>::pointer;
+		using reference = typename std::iterator_traits<segment_iterator>::reference;
+
+		S _segment;
+		S _last;
+		segment_iterator _it;
+
+		constexpr ChainIterator () : _segment(), _last(), _it() {}
+		constexpr ChainIterator (S segment, S last) : _segment(segment), _last(last), _it() {
+			if (segment != last) this->_it = std::begin(*segment);
+			this->normalize();
+		}
+
+		constexpr ChainIterator (S segment, S last, segment_iterator it) : _segment(segment), _last(last), _it(it) {
+			this->normalize();
+		}
+
+		constexpr void normalize () {
+			while (this->_segment != this->_last and this->_it == std::end(*this->_segment)) {
+				++this->_segment;
+				if (this->_segment != this->_last) this->_it = std::begin(*this->_segment);
+			}
+		}
+
+		constexpr reference operator* () const { return *this->_it; }
+
+		constexpr auto& operator++ () {
+			++this->_it;
+			this->normalize();
+			return *this;
+		}
+
+		constexpr auto operator++ (int) {
+			auto copy = *this;
+			++*this;
+			return copy;
 		}
 
-		auto pop_back (size_t const un) {
-			return __ranger::pop_back<I>(*this, un);
+		constexpr bool operator== (ChainIterator const& b) const {
+			return this->_segment == b._segment and (this->_segment == this->_last or this->_it == b._it);
 		}
 
-		auto pop_front () {
-			return __ranger::pop_front<I>(*this, 1);
+		constexpr bool operator!= (ChainIterator const& b) const { return not (*this == b); }
+	};
+
+	// a range over a sequence of segments,  without concatenating them
+	// drop, take, size, count, contains and put work a segment at a time
+	template <typename S>
+	struct ChainRange : public Range<ChainIterator<S>> {
+		using iterator = ChainIterator<S>;
+		using segment_type = Range<typename iterator::segment_iterator>;
+
+		constexpr ChainRange (iterator begin, iterator end) : Range<iterator>(begin, end) {}
+
+		// the contiguous part of the first segment
+		constexpr auto segment () const {
+			auto const b = this->begin();
+			auto const e = this->end();
+			if (b == e) return segment_type(b._it, b._it);
+			return segment_type(b._it, b._segment == e._segment ? e._it : std::end(*b._segment));
 		}
 
-		auto pop_front (size_t const un) {
-			return __ranger::pop_front<I>(*this, un);
+		// segment(),  but as a pointer range if the segments have data(),  for the memchr/memmove fast paths
+		constexpr auto contiguous_segment () const {
+			using T = std::remove_reference_t<decltype(*std::declval<S>())>;
+			if constexpr(has_data<T>::value) {
+				using pointer = decltype(std::declval<T&>().data());
+				auto const s = this->segment();
+				if (s.empty()) return Range<pointer>(nullptr, nullptr);
+
+				auto& x = *this->begin()._segment;
+				auto const p = x.data() + std::distance(std::begin(x), s.begin());
+				return Range<pointer>(p, p + std::distance(s.begin(), s.end()));
+			} else {
+				return this->segment();
+			}
 		}
 
+		// calls `f(contiguous_segment())` for each contiguous part,  until `f` returns false
+		// returns false if stopped by `f`
 		template <typename F>
-		auto pop_until (F const f) {
-			return __ranger::pop_until<I>(*this, f);
+		constexpr bool each_segment (F const f) const {
+			for (auto a = *this; not a.empty();) {
+				auto const s = a.segment();
+				if (not f(a.contiguous_segment())) return false;
+				a._begin = iterator(a._begin._segment, a._begin._last, s.end());
+			}
+
+			return true;
+		}
+
+		constexpr auto size () const {
+			size_t result = 0;
+			this->each_segment([&](auto const s) {
+				result += static_cast<size_t>(std::distance(s.begin(), s.end()));
+				return true;
+			});
+
+			return result;
+		}
+
+		constexpr auto pop_front () {
+			return this->pop_front(1);
+		}
+
+		constexpr auto pop_front (size_t un) {
+			auto const copy = this->begin();
+
+			while (un > 0 and not this->empty()) {
+				auto const s = this->segment();
+				auto const k = std::min(un, static_cast<size_t>(std::distance(s.begin(), s.end())));
+				this->_begin = iterator(this->_begin._segment, this->_begin._last, std::next(s.begin(), static_cast<typename iterator::difference_type>(k)));
+				un -= k;
+			}
+
+			return ChainRange(copy, this->begin());
+		}
+
+		constexpr auto drop (size_t const un) const {
+			auto copy = *this;
+			copy.pop_front(un);
+			return copy;
+		}
+
+		constexpr auto take (size_t const un) const {
+			return ChainRange(this->begin(), this->drop(un).begin());
 		}
 
 		template <typename F>
-		auto pop_back_until (F const f) {
-			return __ranger::pop_back_until<I>(*this, f);
+		constexpr size_t count (F const f) const {
+			size_t result = 0;
+			this->each_segment([&](auto const s) {
+				result += s.count(f);
+				return true;
+			});
+
+			return result;
 		}
 
+		// matches within a segment,  then those that straddle the end of each segment
+		template <typename B>
+		constexpr bool contains (B const& b) const {
+			auto const needle = as_contiguous_range(b);
+			auto const m = static_cast<size_t>(std::distance(needle.begin(), needle.end()));
+			if (m == 0) return not this->empty();
+
+			for (auto a = *this; not a.empty();) {
+				auto const s = a.segment();
+				if (a.contiguous_segment().contains(needle)) return true;
+
+				auto const n = static_cast<size_t>(std::distance(s.begin(), s.end()));
+				auto it = std::next(s.begin(), static_cast<typename iterator::difference_type>(n >= m ? n - (m - 1) : 0));
+				for (; it != s.end(); ++it) {
+					auto const straddle = Range<iterator>(iterator(a._begin._segment, a._begin._last, it), this->end());
+					if (straddle.starts_with(needle)) return true;
+				}
+
+				a._begin = iterator(a._begin._segment, a._begin._last, s.end());
+			}
+
+			return false;
+		}
+
+		// writes `e` (an element or a range) a segment at a time,  returns false if out of space
 		template <typename E>
-		auto put (E const e) { return __ranger::put(*this, e); }
+		constexpr auto put (E const& e) {
+			if constexpr(std::is_convertible_v<E, typename Range<iterator>::value_type>) {
+				if (this->empty()) return false;
+				this->front() = e;
+				this->pop_front();
+				return true;
+			} else {
+				auto b = as_range(e);
+
+				while (not b.empty()) {
+					if (this->empty()) return false;
+
+					auto const s = this->segment();
+					size_t written = 0;
+
+					if constexpr(decltype(b)::is_random_access::value and segment_type::is_random_access::value) {
+						written = std::min(s.size(), b.size());
+						std::copy(b.begin(), b.begin() + static_cast<typename decltype(b)::distance_type>(written), s.begin());
+						b.pop_front(written);
+					} else {
+						for (auto it = s.begin(); it != s.end() and not b.empty(); ++it, ++written) {
+							*it = b.front();
+							b.pop_front();
+						}
+					}
+
+					this->pop_front(written);
+				}
+
+				return true;
+			}
+		}
+	};
+
+	template <typename R, typename = void>
+	struct has_segment : std::false_type {};
+
+	template <typename R>
+	struct has_segment<R, std::void_t<decltype(std::declval<R const&>().segment())>> : std::true_type {};
+
+	// finds the next `_delimiter`,  using memchr for byte pointers
+	template <typename T>
+	struct Delimiter {
+		T _delimiter;
+
+		template <typename I>
+		I operator() (I const begin, I const end) const {
+			if constexpr(is_byte_pointer<I>()) {
+				auto const n = static_cast<size_t>(end - begin);
+				auto const found = std::memchr(begin, static_cast<uint8_t>(this->_delimiter), n);
+				return found ? static_cast<I>(found) : end;
+			} else {
+				return std::find(begin, end, this->_delimiter);
+			}
+		}
+	};
+
+	// finds the next of a set of byte delimiters,  using a bitmap
+	struct AnyOf {
+		uint64_t _set[4] = {};
+
+		AnyOf () = default;
+
+		template <typename R>
+		explicit AnyOf (R const& set) {
+			for (auto const c : set) {
+				auto const b = static_cast<uint8_t>(c);
+				this->_set[b >> 6] |= uint64_t(1) << (b & 63);
+			}
+		}
+
+		auto has (uint8_t const b) const {
+			return ((this->_set[b >> 6] >> (b & 63)) & 1) != 0;
+		}
+
+		template <typename I>
+		I operator() (I begin, I const end) const {
+			static_assert(sizeof(*begin) == 1, "Expected byte elements");
+
+			while (begin != end and not this->has(static_cast<uint8_t>(*begin))) ++begin;
+			return begin;
+		}
+	};
+
+	// skips delimiters between pairs of `_quote`,  an unterminated quote extends to the end
+	template <typename F, typename T>
+	struct Quoted {
+		F _find;
+		T _quote;
+
+		template <typename I>
+		I operator() (I begin, I const end) const {
+			auto const quote = Delimiter<T>{this->_quote};
+
+			for (;;) {
+				auto const q = quote(begin, end);
+				auto const d = this->_find(begin, q);
+				if (d != q or q == end) return d;
+
+				begin = quote(std::next(q), end);
+				if (begin == end) return end;
+				++begin;
+			}
+		}
+	};
+
+	// yields the (possibly empty) fields of a range between the delimiters found by F
+	template <typename R, typename F>
+	struct SplitIterator {
+		using I = typename R::iterator;
+
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = R;
+		using difference_type = std::ptrdiff_t;
+		using pointer = void;
+		using reference = R;
+
+		I _begin;
+		I _field_end;
+		I _end;
+		F _find;
+		bool _done;
+
+		SplitIterator () : _begin(), _field_end(), _end(), _find(), _done(true) {}
+		SplitIterator (I begin, I end, F find) : _begin(begin), _field_end(find(begin, end)), _end(end), _find(find), _done(false) {}
+
+		reference operator* () const { return R(this->_begin, this->_field_end); }
+
+		auto& operator++ () {
+			if (this->_field_end == this->_end) {
+				this->_done = true;
+				return *this;
+			}
+
+			this->_begin = std::next(this->_field_end);
+			this->_field_end = this->_find(this->_begin, this->_end);
+			return *this;
+		}
+
+		auto operator++ (int) {
+			auto copy = *this;
+			++*this;
+			return copy;
+		}
+
+		bool operator== (SplitIterator const& b) const {
+			if (this->_done or b._done) return this->_done == b._done;
+			return this->_begin == b._begin;
+		}
+
+		bool operator!= (SplitIterator const& b) const { return not (*this == b); }
 	};
 
+	template <typename R, typename = void>
+	struct policy_of { using type = Clamping; };
+
+	template <typename R>
+	struct policy_of<R, std::void_t<typename R::policy>> { using type = typename R::policy; };
+
+	// std::lower_bound and std::upper_bound,  but constexpr before C++20
+	template <typename I, typename T, typename F>
+	constexpr I lower_bound (I first, I const last, T const& value, F const f) {
+		auto n = std::distance(first, last);
+
+		while (n > 0) {
+			auto const half = n / 2;
+			auto const middle = std::next(first, half);
+
+			if (f(*middle, value)) {
+				first = std::next(middle);
+				n -= half + 1;
+			} else {
+				n = half;
+			}
+		}
+
+		return first;
+	}
+
+	template <typename I, typename T, typename F>
+	constexpr I upper_bound (I first, I const last, T const& value, F const f) {
+		auto n = std::distance(first, last);
+
+		while (n > 0) {
+			auto const half = n / 2;
+			auto const middle = std::next(first, half);
+
+			if (not f(value, *middle)) {
+				first = std::next(middle);
+				n -= half + 1;
+			} else {
+				n = half;
+			}
+		}
+
+		return first;
+	}
+
 	template <typename I, typename F>
 	struct OrderedRange : public Range<I> {
-		OrderedRange (I begin, I end) : Range<I>(begin, end) {}
+		constexpr OrderedRange (I begin, I end) : Range<I>(begin, end) {}
 
 		using value_type = typename Range<I>::value_type;
 
-		auto contains (value_type const& value) const {
-			return std::binary_search(this->begin(), this->end(), value, F());
+		constexpr auto contains (value_type const& value) const {
+			auto const it = this->lower_bound(value);
+			return it != this->end() and not F()(value, *it);
 		}
 
-		auto lower_bound (value_type const& value) const {
-			return std::lower_bound(this->begin(), this->end(), value, F());
+		constexpr auto lower_bound (value_type const& value) const {
+			return __ranger::lower_bound(this->begin(), this->end(), value, F());
 		}
 
-		auto upper_bound (value_type const& value) const {
-			return std::upper_bound(this->begin(), this->end(), value, F());
+		constexpr auto upper_bound (value_type const& value) const {
+			return __ranger::upper_bound(this->begin(), this->end(), value, F());
 		}
 	};
 }
 
 namespace ranger {
-	template <typename I> using range_t = __ranger::Range<I>;
+	namespace policy {
+		using unchecked = __ranger::Unchecked;
+		using clamping = __ranger::Clamping;
+		using trapping = __ranger::Trapping;
+	}
+
+	template <typename I, typename P = policy::clamping> using range_t = __ranger::Range<I, P>;
+
+	// summation modes,  for Range::sum
+	inline constexpr auto fast = __ranger::Fast{};
+	inline constexpr auto kahan = __ranger::Kahan{};
+	inline constexpr auto pairwise = __ranger::Pairwise{};
 
 	template <typename I>
-	auto range (I begin, I end) {
+	constexpr auto range (I begin, I end) {
 		return range_t<I>(begin, end);
 	}
 
+	// ranges keep their policy
 	template <typename R>
-	auto range (R& r) {
+	constexpr auto range (R& r) {
 		using iterator = decltype(r.begin());
-		return range_t<iterator>(r.begin(), r.end());
+		using policy = typename __ranger::policy_of<R>::type;
+		return range_t<iterator, policy>(r.begin(), r.end());
 	}
 
 	template <typename R>
-	auto ptr_range (R& r) {
+	constexpr auto ptr_range (R& r) {
 		using pointer = decltype(r.data());
-		return range_t<pointer>(r.data(), r.data() + r.size());
+		using policy = typename __ranger::policy_of<R>::type;
+		return range_t<pointer, policy>(r.data(), r.data() + r.size());
 	}
 
-	inline auto zstr_range (const char* z) {
+	template <typename P, typename R>
+	constexpr auto with_policy (R& r) {
+		using iterator = decltype(r.begin());
+		return range_t<iterator, P>(r.begin(), r.end());
+	}
+
+	template <typename R> constexpr auto unchecked (R& r) { return with_policy<policy::unchecked, R>(r); }
+	template <typename R> constexpr auto clamping (R& r) { return with_policy<policy::clamping, R>(r); }
+	template <typename R> constexpr auto trapping (R& r) { return with_policy<policy::trapping, R>(r); }
+
+	constexpr auto zstr_range (const char* z) {
 		auto r = z;
 		while (*r != '\0') r++;
 		return range(z, r);
 	}
 
 	template <typename R>
-	auto reverse (R& r) {
+	constexpr auto reverse (R& r) {
 		using reverse_iterator = std::reverse_iterator<decltype(r.begin())>;
-		return range(reverse_iterator(r.end()), reverse_iterator(r.begin()));
+		using policy = typename __ranger::policy_of<R>::type;
+		return range_t<reverse_iterator, policy>(reverse_iterator(r.end()), reverse_iterator(r.begin()));
+	}
+
+	template <typename I> using sized_range_t = __ranger::SizedRange<I>;
+
+	template <typename I>
+	constexpr auto counted (I begin, size_t const n) {
+		return sized_range_t<I>(begin, n);
+	}
+
+	// O(1) if `r` has a size(),  otherwise counts the elements once
+	template <typename R>
+	constexpr auto sized (R& r) {
+		using iterator = decltype(r.begin());
+		if constexpr(__ranger::has_size<R>::value) {
+			return sized_range_t<iterator>(r.begin(), static_cast<size_t>(r.size()));
+		} else {
+			return sized_range_t<iterator>(r.begin(), static_cast<size_t>(std::distance(r.begin(), r.end())));
+		}
+	}
+
+	template <typename S> using chain_range_t = __ranger::ChainRange<S>;
+
+	// a range over the elements of each segment in `segments` (a container of ranges or containers),  in order
+	// `segments` is not copied,  and must outlive the result
+	template <typename R>
+	constexpr auto chain (R& segments) {
+		using iterator = __ranger::ChainIterator<decltype(segments.begin())>;
+		return chain_range_t<decltype(segments.begin())>(
+			iterator(segments.begin(), segments.end()),
+			iterator(segments.end(), segments.end())
+		);
+	}
+
+	template <typename I, typename P = policy::clamping, typename F = __ranger::Address> using prefetch_range_t = range_t<__ranger::PrefetchIterator<I, F>, P>;
+
+	// iterating the result prefetches `f(element)` for the element `distance` ahead,  for random access ranges
+	template <typename R, typename F>
+	constexpr auto prefetch_by (R& r, F const f, size_t const distance = 8) {
+		using iterator = decltype(r.begin());
+		using policy = typename __ranger::policy_of<R>::type;
+		using prefetch_iterator = __ranger::PrefetchIterator<iterator, F>;
+
+		auto const n = static_cast<typename prefetch_iterator::difference_type>(distance);
+		return prefetch_range_t<iterator, policy, F>(prefetch_iterator(r.begin(), r.end(), n, f), prefetch_iterator(r.end(), r.end(), 0, f));
+	}
+
+	// the elements themselves
+	template <typename R>
+	constexpr auto prefetch (R& r, size_t const distance = 8) {
+		return prefetch_by(r, __ranger::Address{}, distance);
+	}
+
+	// what pointer elements point to
+	template <typename R>
+	constexpr auto prefetch_pointee (R& r, size_t const distance = 8) {
+		return prefetch_by(r, __ranger::Pointee{}, distance);
+	}
+
+	// the elements of `base` that index elements refer to
+	template <typename R, typename T>
+	constexpr auto prefetch_indexed (R& r, T const* const base, size_t const distance = 8) {
+		return prefetch_by(r, __ranger::Indexed<T>{base}, distance);
+	}
+
+	template <typename R, typename F>
+	auto split_by (R& r, F const find) {
+		auto const a = range(r);
+		using iterator = __ranger::SplitIterator<std::remove_const_t<decltype(a)>, F>;
+		return range_t<iterator>(iterator(a.begin(), a.end(), find), iterator());
+	}
+
+	// lazily splits `r` into subranges between each `delimiter`,  empty fields are kept
+	template <typename R, typename T>
+	auto split (R& r, T const delimiter) {
+		using value_type = typename decltype(range(r))::value_type;
+		return split_by(r, __ranger::Delimiter<value_type>{static_cast<value_type>(delimiter)});
+	}
+
+	// as split,  but delimiters between pairs of `quote` are ignored
+	template <typename R, typename T>
+	auto split (R& r, T const delimiter, T const quote) {
+		using value_type = typename decltype(range(r))::value_type;
+		using find = __ranger::Delimiter<value_type>;
+		return split_by(r, __ranger::Quoted<find, value_type>{
+			find{static_cast<value_type>(delimiter)},
+			static_cast<value_type>(quote)
+		});
+	}
+
+	// as split,  but for any of the bytes in `set`
+	template <typename R, typename S>
+	auto split_any (R& r, S const& set) {
+		return split_by(r, __ranger::AnyOf(set));
+	}
+
+	template <typename R, typename S, typename T>
+	auto split_any (R& r, S const& set, T const quote) {
+		using value_type = typename decltype(range(r))::value_type;
+		return split_by(r, __ranger::Quoted<__ranger::AnyOf, value_type>{
+			__ranger::AnyOf(set),
+			static_cast<value_type>(quote)
+		});
+	}
+
+	// `r` as a pointer range if it has data(),  for the memchr/memmove fast paths,  otherwise as range(r)
+	// mutable for a mutable `r`
+	template <typename R>
+	auto contiguous_range (R& r) {
+		if constexpr(__ranger::has_data<R>::value) {
+			return ptr_range(r);
+		} else {
+			return range(r);
+		}
+	}
+
+	// the exact size of join(ranges, separator, out)
+	template <typename R, typename S>
+	size_t joined_size (R const& ranges, S const& separator) {
+		size_t result = 0;
+		size_t n = 0;
+		for (auto const& x : ranges) {
+			auto const a = contiguous_range(x);
+			static_assert(decltype(a)::is_random_access::value, "Expected random access ranges");
+			result += a.size();
+			++n;
+		}
+
+		return n == 0 ? 0 : result + (n - 1) * contiguous_range(separator).size();
+	}
+
+	// writes `ranges` separated by `separator` into `out`,  advancing it
+	// returns false if `out` is too small,  leaving it unchanged (but possibly partly written)
+	// size `out` with joined_size,  the space is checked while writing
+	template <typename R, typename S, typename B>
+	bool join (R const& ranges, S const& separator, B& out) {
+		auto const sep = contiguous_range(separator);
+		auto o = out;
+		auto const append = [&o](auto const& a) {
+			if (o.size() < a.size()) return false;
+			std::copy(a.begin(), a.end(), o.begin());
+			o.pop_front(a.size());
+			return true;
+		};
+
+		auto first = true;
+		for (auto const& x : ranges) {
+			if (not first and not append(sep)) return false;
+			first = false;
+
+			if (not append(contiguous_range(x))) return false;
+		}
+
+		out = o;
+		return true;
+	}
+
+	// the exact size of replace_all(r, from, to, out)
+	template <typename R, typename F, typename T>
+	size_t replaced_size (R const& r, F const& from, T const& to) {
+		auto a = contiguous_range(r);
+		auto const f = contiguous_range(from);
+		static_assert(decltype(a)::is_random_access::value, "Expected a random access range");
+
+		auto const n = a.size();
+		auto const m = f.size();
+		if (m == 0) return n;
+
+		size_t count = 0;
+		for (auto it = __ranger::find(a, f); it != a.end(); it = __ranger::find(a, f)) {
+			++count;
+			a = decltype(a)(it + static_cast<typename decltype(a)::distance_type>(m), a.end());
+		}
+
+		return n - count * m + count * contiguous_range(to).size();
+	}
+
+	// writes `r` into `out` with each (non-overlapping,  leftmost first) occurrence of `from` replaced by `to`,  advancing `out`
+	// an empty `from` matches nothing
+	// returns false if `out` is too small,  leaving it unchanged (but possibly partly written)
+	// size `out` with replaced_size,  the space is checked while writing (one search pass)
+	template <typename R, typename F, typename T, typename B>
+	bool replace_all (R const& r, F const& from, T const& to, B& out) {
+		auto a = contiguous_range(r);
+		auto const f = contiguous_range(from);
+		auto const t = contiguous_range(to);
+		static_assert(decltype(a)::is_random_access::value, "Expected a random access range");
+
+		auto const m = static_cast<typename decltype(a)::distance_type>(f.size());
+		auto o = out;
+		auto const append = [&o](auto const begin, auto const end) {
+			auto const n = static_cast<size_t>(end - begin);
+			if (o.size() < n) return false;
+			std::copy(begin, end, o.begin());
+			o.pop_front(n);
+			return true;
+		};
+
+		for (;;) {
+			auto const it = m == 0 ? a.end() : __ranger::find(a, f);
+			if (not append(a.begin(), it)) return false;
+			if (it == a.end()) break;
+
+			if (not append(t.begin(), t.end())) return false;
+			a = decltype(a)(it + m, a.end());
+		}
+
+		out = o;
+		return true;
 	}
 
 	template <typename F, typename R>
-	auto ordered (R& r) {
+	constexpr auto ordered (R& r) {
 		using iterator = decltype(r.begin());
 		return __ranger::OrderedRange<iterator, F>(r.begin(), r.end());
 	}
 
 	template <typename R>
-	auto ordered (R& r) {
+	constexpr auto ordered (R& r) {
 		return ordered<std::less<>, R>(r);
 	}
 
 	template <typename I>
-	typename std::enable_if_t<
+	constexpr typename std::enable_if_t<
 		range_t<I>::is_input::value,
 		range_t<I>
 	>
@@ -457,10 +1624,42 @@ namespace ranger {
 		return range_t<I>(begin, I{});
 	}
 
+#ifdef RANGER_STATS
+	inline auto& stats () { return __ranger::stats(); }
+	inline void reset_stats () { __ranger::stats() = __ranger::Stats{}; }
+
+	// writes the calling thread's counters as `name calls elements bytes` lines
+	inline void report_stats (std::ostream& os) {
+		auto const& s = __ranger::stats();
+		auto const line = [&](char const* name, __ranger::Stats::Counter const& c) {
+			os << name << ' ' << c.calls << ' ' << c.elements << ' ' << c.bytes << '\n';
+		};
+
+		line("pop_front", s.pop_front);
+		line("pop_back", s.pop_back);
+		line("contains", s.contains);
+		line("put", s.put);
+		line("serial::read", s.serial_read);
+		line("serial::put", s.serial_put);
+	}
+#endif
+
 	// rvalue references wrappers
-	template <typename R> auto range (R&& r) { return range<R>(r); }
-	template <typename R> auto ptr_range (R&& r) { return ptr_range<R>(r); }
-	template <typename R> auto reverse (R&& r) { return reverse<R>(r); }
-	template <typename R> auto ordered (R&& r) { return ordered<R>(r); }
-	template <typename F, typename R> auto ordered (R&& r) { return ordered<R, F>(r); }
+	template <typename R> constexpr auto range (R&& r) { return range<R>(r); }
+	template <typename R> constexpr auto ptr_range (R&& r) { return ptr_range<R>(r); }
+	template <typename R> constexpr auto reverse (R&& r) { return reverse<R>(r); }
+	template <typename P, typename R> constexpr auto with_policy (R&& r) { return with_policy<P, R>(r); }
+	template <typename R> constexpr auto unchecked (R&& r) { return unchecked<R>(r); }
+	template <typename R> constexpr auto clamping (R&& r) { return clamping<R>(r); }
+	template <typename R> constexpr auto trapping (R&& r) { return trapping<R>(r); }
+	template <typename R> constexpr auto sized (R&& r) { return sized<R>(r); }
+	template <typename R> constexpr auto prefetch (R&& r, size_t const distance = 8) { return prefetch<R>(r, distance); }
+	template <typename R> constexpr auto prefetch_pointee (R&& r, size_t const distance = 8) { return prefetch_pointee<R>(r, distance); }
+	template <typename R, typename T> constexpr auto prefetch_indexed (R&& r, T const* const base, size_t const distance = 8) { return prefetch_indexed<R, T>(r, base, distance); }
+	template <typename R, typename T> auto split (R&& r, T const d) { return split<R, T>(r, d); }
+	template <typename R, typename T> auto split (R&& r, T const d, T const q) { return split<R, T>(r, d, q); }
+	template <typename R, typename S> auto split_any (R&& r, S const& set) { return split_any<R, S>(r, set); }
+	template <typename R, typename S, typename T> auto split_any (R&& r, S const& set, T const q) { return split_any<R, S, T>(r, set, q); }
+	template <typename R> constexpr auto ordered (R&& r) { return ordered<R>(r); }
+	template <typename F, typename R> constexpr auto ordered (R&& r) { return ordered<F, R>(r); }
 }
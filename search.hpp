@@ -0,0 +1,179 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <vector>
+#include "ranger.hpp"
+
+namespace search {
+	struct Match {
+		size_t pattern; // index into the patterns
+		size_t begin; // offsets into the haystack
+		size_t end;
+	};
+
+	// Aho-Corasick automaton over bytes,  compiled to a DFA over byte equivalence classes
+	// empty patterns never match,  duplicate patterns report the first index only
+	struct Matcher {
+		static constexpr auto none = std::numeric_limits<uint32_t>::max();
+
+		uint16_t _classes[256] = {}; // byte -> class,  0 for bytes in no pattern
+		size_t _nclasses = 1;
+		std::vector<uint32_t> _next; // state * _nclasses + class -> state
+		std::vector<uint32_t> _output; // state -> pattern ending here,  or none
+		std::vector<uint32_t> _dictionary; // state -> next suffix state with an output,  or none
+		std::vector<size_t> _lengths; // pattern -> length
+		__ranger::AnyOf _first; // bytes that leave the root state
+		size_t _nfirst = 0;
+		uint8_t _single = 0; // if _nfirst == 1
+
+		template <typename R>
+		explicit Matcher (R const& patterns) {
+			for (auto const& pattern : patterns) {
+				for (auto const c : pattern) {
+					auto& cls = this->_classes[static_cast<uint8_t>(c)];
+					if (cls == 0) cls = static_cast<uint16_t>(this->_nclasses++);
+				}
+			}
+
+			// trie
+			this->_next.assign(this->_nclasses, none);
+			this->_output.assign(1, none);
+
+			for (auto const& pattern : patterns) {
+				uint32_t state = 0;
+				size_t length = 0;
+
+				for (auto const c : pattern) {
+					auto const b = static_cast<uint8_t>(c);
+					auto& next = this->_next[state * this->_nclasses + this->_classes[b]];
+
+					if (state == 0 and next == none) {
+						this->_first._set[b >> 6] |= uint64_t(1) << (b & 63);
+						this->_single = b;
+						this->_nfirst += 1;
+					}
+
+					if (next == none) {
+						next = static_cast<uint32_t>(this->_output.size());
+						this->_next.resize(this->_next.size() + this->_nclasses, none);
+						this->_output.push_back(none);
+					}
+
+					state = this->_next[state * this->_nclasses + this->_classes[b]];
+					++length;
+				}
+
+				auto const index = static_cast<uint32_t>(this->_lengths.size());
+				this->_lengths.push_back(length);
+				if (length > 0 and this->_output[state] == none) this->_output[state] = index;
+			}
+
+			// failure links,  breadth first,  completing the DFA as we go
+			auto const states = this->_output.size();
+			auto fail = std::vector<uint32_t>(states, 0);
+			auto queue = std::vector<uint32_t>{};
+			this->_dictionary.assign(states, none);
+
+			for (size_t c = 0; c < this->_nclasses; ++c) {
+				auto& next = this->_next[c];
+				if (next == none) {
+					next = 0;
+				} else {
+					queue.push_back(next);
+				}
+			}
+
+			for (size_t i = 0; i < queue.size(); ++i) {
+				auto const state = queue[i];
+				auto const f = fail[state];
+				this->_dictionary[state] = this->_output[f] != none ? f : this->_dictionary[f];
+
+				for (size_t c = 0; c < this->_nclasses; ++c) {
+					auto& next = this->_next[state * this->_nclasses + c];
+					auto const fallback = this->_next[f * this->_nclasses + c];
+
+					if (next == none) {
+						next = fallback;
+					} else {
+						fail[next] = fallback;
+						queue.push_back(next);
+					}
+				}
+			}
+		}
+
+		// calls `f(Match)` for every match,  in order of their end,  until `f` returns false
+		// returns false if stopped by `f`
+		template <typename R, typename F>
+		bool each (R const& haystack, F const f) const {
+			auto const h = ranger::contiguous_range(haystack);
+			static_assert(__ranger::is_byte_pointer<typename decltype(h)::iterator>(), "Expected a byte pointer range, or bytes with data()");
+
+			auto const begin = h.begin();
+			auto const end = h.end();
+			auto p = begin;
+			uint32_t state = 0;
+
+			if (this->_nfirst == 0) return true;
+
+			while (p != end) {
+				// skip to the next byte that can start a match
+				if (state == 0) {
+					if (this->_nfirst == 1) {
+						p = __ranger::Delimiter<uint8_t>{this->_single}(p, end);
+					} else {
+						p = this->_first(p, end);
+					}
+
+					if (p == end) break;
+				}
+
+				state = this->_next[state * this->_nclasses + this->_classes[static_cast<uint8_t>(*p)]];
+				++p;
+
+				auto out = this->_output[state] != none ? state : this->_dictionary[state];
+				while (out != none) {
+					auto const pattern = this->_output[out];
+					auto const e = static_cast<size_t>(p - begin);
+					if (not f(Match{pattern, e - this->_lengths[pattern], e})) return false;
+
+					out = this->_dictionary[out];
+				}
+			}
+
+			return true;
+		}
+
+		// the match ending first (the longest,  if several end together)
+		template <typename R>
+		std::optional<Match> first (R const& haystack) const {
+			auto result = std::optional<Match>{};
+
+			this->each(haystack, [&](Match const m) {
+				result = m;
+				return false;
+			});
+
+			return result;
+		}
+
+		template <typename R>
+		bool any (R const& haystack) const {
+			return not this->each(haystack, [](Match) { return false; });
+		}
+
+		template <typename R>
+		auto all (R const& haystack) const {
+			auto result = std::vector<Match>{};
+
+			this->each(haystack, [&](Match const m) {
+				result.push_back(m);
+				return true;
+			});
+
+			return result;
+		}
+	};
+}
@@ -1,6 +1,13 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <optional>
+#include <tuple>
 #include "ranger.hpp"
 
 #ifdef __APPLE__
@@ -13,9 +20,18 @@
 #error "big endian architecture not supported"
 #endif
 
+#if defined(__x86_64__) and (defined(__GNUC__) or defined(__clang__))
+#include <nmmintrin.h>
+#define SERIAL_CRC32C_SSE42
+#endif
+
 namespace serial {
+	// integers are composed by shifts,  which is usable in constant expressions (and still compiles to a load)
+	template <typename E>
+	using is_shiftable = std::integral_constant<bool, std::is_integral<E>::value and not std::is_same<E, bool>::value>;
+
 	template <typename E, bool BE = false, typename R>
-	auto peek (R const& r) {
+	constexpr auto peek (R const& r) {
 		using T = typename R::value_type;
 
 		static_assert(std::is_same<T, uint8_t>::value, "Expected uint8_t elements");
@@ -23,64 +39,529 @@ namespace serial {
 
 		constexpr auto count = sizeof(E) / sizeof(T);
 
-		E value;
+		// segmented ranges,  from the first segment if it holds all of `E`
+		if constexpr(__ranger::has_segment<R>::value) {
+			auto const s = r.segment();
+			if (static_cast<size_t>(std::distance(s.begin(), s.end())) >= count) return peek<E, BE>(s);
+		}
+
 		auto copy = ranger::range(r);
-		auto ptr = reinterpret_cast<T*>(&value);
 
-		if (BE) {
+		if constexpr(is_shiftable<E>::value) {
+			using U = std::make_unsigned_t<E>;
+
+			U value = 0;
 			for (size_t i = 0; i < count; ++i, copy.pop_front()) {
-				ptr[count - 1 - i] = copy.front();
+				auto const shift = 8 * (BE ? count - 1 - i : i);
+				value |= static_cast<U>(static_cast<U>(copy.front()) << shift);
 			}
+
+			return static_cast<E>(value);
 		} else {
-			for (size_t i = 0; i < count; ++i, copy.pop_front()) {
-				ptr[i] = copy.front();
+			E value;
+			auto ptr = reinterpret_cast<T*>(&value);
+
+			if (BE) {
+				for (size_t i = 0; i < count; ++i, copy.pop_front()) {
+					ptr[count - 1 - i] = copy.front();
+				}
+			} else {
+				for (size_t i = 0; i < count; ++i, copy.pop_front()) {
+					ptr[i] = copy.front();
+				}
 			}
-		}
 
-		return value;
+			return value;
+		}
 	}
 
 	template <typename E, bool BE = false, typename R>
-	void place (R& r, E const value) {
+	constexpr void place (R& r, E const value) {
 		using T = typename R::value_type;
 
 		static_assert(std::is_same<T, uint8_t>::value, "Expected uint8_t elements");
 		static_assert(sizeof(E) % sizeof(T) == 0, "Padding is unsupported");
 
 		constexpr auto count = sizeof(E) / sizeof(T);
+
+		if constexpr(__ranger::has_segment<R>::value) {
+			auto s = r.segment();
+			if (static_cast<size_t>(std::distance(s.begin(), s.end())) >= count) return place<E, BE>(s, value);
+		}
+
 		auto copy = ranger::range(r);
-		auto ptr = reinterpret_cast<const T*>(&value);
 
-		if (BE) {
+		if constexpr(is_shiftable<E>::value) {
+			using U = std::make_unsigned_t<E>;
+
 			for (size_t i = 0; i < count; ++i, copy.pop_front()) {
-				copy.front() = ptr[count - 1 - i];
+				auto const shift = 8 * (BE ? count - 1 - i : i);
+				copy.front() = static_cast<T>(static_cast<U>(value) >> shift);
 			}
+
 		} else {
-			for (size_t i = 0; i < count; ++i, copy.pop_front()) {
-				copy.front() = ptr[i];
+			auto ptr = reinterpret_cast<const T*>(&value);
+
+			if (BE) {
+				for (size_t i = 0; i < count; ++i, copy.pop_front()) {
+					copy.front() = ptr[count - 1 - i];
+				}
+			} else {
+				for (size_t i = 0; i < count; ++i, copy.pop_front()) {
+					copy.front() = ptr[i];
+				}
 			}
 		}
 	}
 
 	template <typename E, bool BE = false, typename R>
-	auto read (R& r) {
+	constexpr auto read (R& r) {
 		using T = typename R::value_type;
 
+		RANGER_STAT(serial_read, 0, sizeof(E));
 		auto const e = peek<E, BE, R>(r);
 		r = r.drop(sizeof(E) / sizeof(T));
 		return e;
 	}
 
 	template <typename E, bool BE = false, typename R>
-	void put (R& r, E const e) {
+	constexpr void put (R& r, E const e) {
 		using T = typename R::value_type;
 
+		RANGER_STAT(serial_put, 0, sizeof(E));
 		place<E, BE, R>(r, e);
 		r = r.drop(sizeof(E) / sizeof(T));
 	}
 
+	// CRC32C (Castagnoli),  slicing-by-8 tables
+	constexpr auto crc32c_tables () {
+		auto t = std::array<std::array<uint32_t, 256>, 8>{};
+
+		for (uint32_t i = 0; i < 256; ++i) {
+			auto c = i;
+			for (auto k = 0; k < 8; ++k) c = (c >> 1) ^ ((c & 1) ? 0x82F63B78u : 0u);
+			t[0][i] = c;
+		}
+
+		for (size_t k = 1; k < 8; ++k) {
+			for (size_t i = 0; i < 256; ++i) {
+				t[k][i] = (t[k - 1][i] >> 8) ^ t[0][t[k - 1][i] & 0xff];
+			}
+		}
+
+		return t;
+	}
+
+	inline constexpr auto crc32c_table = crc32c_tables();
+
+	inline uint32_t crc32c_table8 (uint32_t crc, uint8_t const* p, size_t n) {
+		auto const& t = crc32c_table;
+
+		for (; n >= 8; p += 8, n -= 8) {
+			uint64_t x;
+			std::memcpy(&x, p, sizeof(x));
+			x ^= crc;
+			crc = t[7][x & 0xff] ^ t[6][(x >> 8) & 0xff] ^ t[5][(x >> 16) & 0xff] ^ t[4][(x >> 24) & 0xff] ^
+				t[3][(x >> 32) & 0xff] ^ t[2][(x >> 40) & 0xff] ^ t[1][(x >> 48) & 0xff] ^ t[0][x >> 56];
+		}
+
+		for (; n > 0; ++p, --n) crc = (crc >> 8) ^ t[0][(crc ^ *p) & 0xff];
+		return crc;
+	}
+
+#ifdef SERIAL_CRC32C_SSE42
+	__attribute__((target("sse4.2")))
+	inline uint32_t crc32c_sse42 (uint32_t crc, uint8_t const* p, size_t n) {
+		uint64_t c = crc;
+
+		for (; n >= 8; p += 8, n -= 8) {
+			uint64_t x;
+			std::memcpy(&x, p, sizeof(x));
+			c = _mm_crc32_u64(c, x);
+		}
+
+		crc = static_cast<uint32_t>(c);
+		for (; n > 0; ++p, --n) crc = _mm_crc32_u8(crc, *p);
+		return crc;
+	}
+
+	inline bool has_sse42 () {
+		static bool const has = __builtin_cpu_supports("sse4.2");
+		return has;
+	}
+#endif
+
+	// continues from a previous result `crc` (0 to start),  like zlib's crc32
+	// contiguous containers (with data()) take the pointer fast paths
+	template <typename R>
+	uint32_t crc32c (R const& r, uint32_t const crc = 0) {
+		auto const a = ranger::contiguous_range(r);
+		using iterator = typename decltype(a)::iterator;
+		static_assert(sizeof(typename decltype(a)::value_type) == 1, "Expected byte elements");
+
+		auto c = ~crc;
+
+		if constexpr(std::is_pointer_v<iterator>) {
+			auto const p = reinterpret_cast<uint8_t const*>(a.begin());
+#ifdef SERIAL_CRC32C_SSE42
+			if (has_sse42()) return ~crc32c_sse42(c, p, a.size());
+#endif
+			return ~crc32c_table8(c, p, a.size());
+		} else {
+			for (auto const x : a) c = (c >> 8) ^ crc32c_table[0][(c ^ static_cast<uint8_t>(x)) & 0xff];
+			return ~c;
+		}
+	}
+
+	// Adler-32,  continues from a previous result `adler` (1 to start)
+	template <typename R>
+	uint32_t adler32 (R const& r, uint32_t const adler = 1) {
+		auto const a = ranger::contiguous_range(r);
+		static_assert(sizeof(typename decltype(a)::value_type) == 1, "Expected byte elements");
+
+		uint32_t s1 = adler & 0xffff;
+		uint32_t s2 = adler >> 16;
+		size_t n = 0;
+
+		for (auto const x : a) {
+			s1 += static_cast<uint8_t>(x);
+			s2 += s1;
+
+			// 5552 is the most bytes before s2 can overflow 32 bits
+			if (++n == 5552) {
+				s1 %= 65521;
+				s2 %= 65521;
+				n = 0;
+			}
+		}
+
+		s1 %= 65521;
+		s2 %= 65521;
+		return (s2 << 16) | s1;
+	}
+
+	// reads from a range,  checksumming (CRC32C) each consumed byte as it goes
+	template <typename R>
+	struct Crc32cReader {
+		R _range;
+		uint32_t _crc = 0;
+
+		auto range () const { return this->_range; }
+		auto crc () const { return this->_crc; }
+		auto empty () const { return this->_range.empty(); }
+		auto verify (uint32_t const expected) const { return this->_crc == expected; }
+
+		template <typename E, bool BE = false>
+		auto read () {
+			using T = typename R::value_type;
+
+			auto const e = peek<E, BE, R>(this->_range);
+			this->take(sizeof(E) / sizeof(T));
+			return e;
+		}
+
+		// consumes,  and returns,  the next `n` elements
+		auto take (size_t const n) {
+			auto const consumed = this->_range.pop_front(n);
+			this->_crc = crc32c(consumed, this->_crc);
+			return consumed;
+		}
+	};
+
+	// over a pointer range for contiguous containers,  so each take() is checksummed on the fast path
+	template <typename R>
+	auto crc32c_reader (R const& r) {
+		using range = decltype(ranger::contiguous_range(r));
+		return Crc32cReader<range>{ranger::contiguous_range(r)};
+	}
+
+	// writes values of up to 32 bits,  least significant bit first
+	template <typename R>
+	struct BitWriter {
+		R _range;
+		uint64_t _buffer = 0;
+		unsigned _count = 0;
+
+		auto range () const { return this->_range; }
+
+		// returns false if the range is full
+		bool write (uint32_t const value, unsigned const bits) {
+			assert(bits <= 32);
+
+			auto const mask = bits == 32 ? ~uint64_t(0) >> 32 : (uint64_t(1) << bits) - 1;
+			this->_buffer |= (value & mask) << this->_count;
+			this->_count += bits;
+
+			for (; this->_count >= 8; this->_count -= 8, this->_buffer >>= 8) {
+				if (not this->_range.put(static_cast<uint8_t>(this->_buffer))) return false;
+			}
+
+			return true;
+		}
+
+		// writes any partial byte,  zero padded
+		bool flush () {
+			if (this->_count == 0) return true;
+
+			this->_count = 0;
+			auto const b = static_cast<uint8_t>(this->_buffer);
+			this->_buffer = 0;
+			return this->_range.put(b);
+		}
+	};
+
+	// reads values of up to 32 bits,  least significant bit first
+	// reading past the end yields zero bits and sets overrun()
+	template <typename R>
+	struct BitReader {
+		R _range;
+		uint64_t _buffer = 0;
+		unsigned _count = 0;
+		bool _overrun = false;
+
+		auto range () const { return this->_range; }
+		auto overrun () const { return this->_overrun; }
+
+		uint32_t read (unsigned const bits) {
+			assert(bits <= 32);
+
+			for (; this->_count < bits; this->_count += 8) {
+				if (this->_range.empty()) {
+					this->_overrun = true;
+				} else {
+					this->_buffer |= uint64_t(static_cast<uint8_t>(this->_range.front())) << this->_count;
+					this->_range.pop_front();
+				}
+			}
+
+			auto const mask = bits == 32 ? ~uint64_t(0) >> 32 : (uint64_t(1) << bits) - 1;
+			auto const value = static_cast<uint32_t>(this->_buffer & mask);
+			this->_buffer >>= bits;
+			this->_count -= bits;
+			return value;
+		}
+	};
+
+	template <typename R>
+	auto bit_writer (R& r) {
+		using range = decltype(ranger::range(r));
+		return BitWriter<range>{ranger::range(r)};
+	}
+
+	template <typename R>
+	auto bit_reader (R& r) {
+		using range = decltype(ranger::range(r));
+		return BitReader<range>{ranger::range(r)};
+	}
+
+	// the bits needed for the largest offset from `base` in `r`
+	template <typename R>
+	unsigned bit_width (R const& r, uint32_t const base) {
+		uint32_t any = 0;
+		for (auto const x : ranger::range(r)) any |= static_cast<uint32_t>(x - base);
+
+		unsigned bits = 0;
+		for (; any != 0; any >>= 1) ++bits;
+		return bits;
+	}
+
+	// frame-of-reference block codec
+	// N (a multiple of 128) integers are stored as `bits` wide offsets from `base`,  in N * bits / 8 bytes
+	// values are interleaved over 4 lanes of 32-bit words,  so each step shifts 4 values alike (and vectorizes)
+	constexpr size_t block_lanes = 4;
+
+	template <size_t N>
+	constexpr size_t packed_size (unsigned const bits) {
+		static_assert(N % 128 == 0, "Expected a multiple of 128 integers");
+		return N * bits / 8;
+	}
+
+	// packs the first N integers of `in` into `out`,  advancing `out`
+	// returns false (writing nothing) if `in` is too short,  `out` too small,
+	// or a value is outside [base, base + 2^bits)
+	template <size_t N = 128, typename A, typename B>
+	bool pack (A const& in, uint32_t const base, unsigned const bits, B& out) {
+		auto const a = ranger::ptr_range(in);
+		auto const bytes = packed_size<N>(bits);
+		assert(bits <= 32);
+
+		if (a.size() < N or out.size() < bytes) return false;
+
+		uint32_t words[N] = {};
+		uint32_t overflow = 0;
+		auto const mask = bits == 32 ? ~uint32_t(0) : (uint32_t(1) << bits) - 1;
+		auto const p = a.data();
+
+		for (size_t k = 0; k < N / block_lanes; ++k) {
+			auto const position = k * bits;
+			auto const w = position / 32;
+			auto const shift = position % 32;
+
+			for (size_t l = 0; l < block_lanes; ++l) {
+				auto const v = static_cast<uint32_t>(p[k * block_lanes + l] - base);
+				overflow |= v & ~mask;
+				words[w * block_lanes + l] |= v << shift;
+				if (shift + bits > 32) words[(w + 1) * block_lanes + l] |= v >> (32 - shift);
+			}
+		}
+
+		if (overflow != 0) return false;
+
+		std::memcpy(out.data(), words, bytes);
+		out = out.drop(bytes);
+		return true;
+	}
+
+	// unpacks N integers from `in` into `out`,  advancing `in`
+	// returns false if `in` is too short,  or `out` too small
+	template <size_t N = 128, typename A, typename B>
+	bool unpack (A& in, uint32_t const base, unsigned const bits, B& out) {
+		auto const o = ranger::ptr_range(out);
+		auto const bytes = packed_size<N>(bits);
+		assert(bits <= 32);
+
+		if (in.size() < bytes or o.size() < N) return false;
+
+		uint32_t words[N + block_lanes] = {};
+		std::memcpy(words, in.data(), bytes);
+
+		auto const mask = bits == 32 ? ~uint32_t(0) : (uint32_t(1) << bits) - 1;
+		auto const p = o.data();
+
+		for (size_t k = 0; k < N / block_lanes; ++k) {
+			auto const position = k * bits;
+			auto const w = position / 32;
+			auto const shift = position % 32;
+
+			for (size_t l = 0; l < block_lanes; ++l) {
+				auto v = words[w * block_lanes + l] >> shift;
+				if (shift + bits > 32) v |= words[(w + 1) * block_lanes + l] << (32 - shift);
+				p[k * block_lanes + l] = (v & mask) + base;
+			}
+		}
+
+		in = in.drop(bytes);
+		return true;
+	}
+
+	// reads a frame of an `E` length prefix (big endian if BE) and that many elements,  advancing `r`
+	// returns the frame (a range over `r`),  or nothing if truncated (leaving `r` unchanged)
+	template <typename E, bool BE = false, typename R>
+	constexpr std::optional<R> read_frame (R& r) {
+		using T = typename R::value_type;
+		constexpr auto prefix = sizeof(E) / sizeof(T);
+
+		if (r.size() < prefix) return std::nullopt;
+
+		auto const n = static_cast<size_t>(peek<E, BE, R>(r));
+		auto const body = r.drop(prefix);
+		if (body.size() < n) return std::nullopt;
+
+		r = body.drop(n);
+		return body.take(n);
+	}
+
+	// a forward iterator over consecutive length prefixed frames,  see read_frame
+	// iteration ends at the first truncated frame,  rest() is then non-empty
+	template <typename E, bool BE, typename R>
+	struct FrameIterator {
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = R;
+		using difference_type = std::ptrdiff_t;
+		using pointer = R const*;
+		using reference = R const&;
+
+		R _rest; // after the current frame
+		R _frame;
+		bool _done;
+
+		constexpr FrameIterator () : _rest(R({}, {})), _frame(R({}, {})), _done(true) {}
+		constexpr explicit FrameIterator (R const r) : _rest(r), _frame(r), _done(false) { ++*this; }
+
+		// the elements from the current frame (its prefix) onwards,  or those left over if done
+		constexpr auto rest () const {
+			if (this->_done) return this->_rest;
+			return R(this->_frame.begin() - static_cast<std::ptrdiff_t>(sizeof(E) / sizeof(typename R::value_type)), this->_rest.end());
+		}
+
+		constexpr reference operator* () const { return this->_frame; }
+		constexpr pointer operator-> () const { return &this->_frame; }
+
+		constexpr auto& operator++ () {
+			if (auto const frame = read_frame<E, BE, R>(this->_rest)) {
+				this->_frame = *frame;
+			} else {
+				this->_done = true;
+			}
+
+			return *this;
+		}
+
+		constexpr auto operator++ (int) {
+			auto copy = *this;
+			++*this;
+			return copy;
+		}
+
+		constexpr bool operator== (FrameIterator const& b) const {
+			if (this->_done or b._done) return this->_done == b._done;
+			return this->_rest.begin() == b._rest.begin();
+		}
+
+		constexpr bool operator!= (FrameIterator const& b) const { return not (*this == b); }
+	};
+
+	// the frames of `r`,  lazily,  as ranges over `r`
+	template <typename E, bool BE = false, typename R>
+	constexpr auto frames (R const& r) {
+		using range = decltype(ranger::range(r));
+		using iterator = FrameIterator<E, BE, range>;
+		return ranger::range_t<iterator>(iterator(ranger::range(r)), iterator());
+	}
+
+	// a fixed layout of fields `E...` at the start of a range,  each decoded only when accessed
+	template <typename R, typename... E>
+	struct Record {
+		using T = typename R::value_type;
+
+		static constexpr size_t sizes[] = {sizeof(E) / sizeof(T)...};
+		static constexpr size_t size = (sizeof(E) + ... + 0) / sizeof(T);
+
+		template <size_t I>
+		static constexpr size_t offset () {
+			size_t result = 0;
+			for (size_t i = 0; i < I; ++i) result += sizes[i];
+			return result;
+		}
+
+		R _range;
+
+		// false if `range()` is too short for the fields
+		constexpr auto valid () const { return this->_range.size() >= size; }
+		constexpr auto range () const { return this->_range; }
+
+		// the elements after the fields,  e.g. a variable length payload
+		constexpr auto rest () const { return this->_range.drop(size); }
+
+		template <size_t I, bool BE = false>
+		constexpr auto get () const {
+			using F = std::tuple_element_t<I, std::tuple<E...>>;
+
+			assert(this->valid());
+			return peek<F, BE>(this->_range.drop(offset<I>()));
+		}
+	};
+
+	template <typename... E, typename R>
+	constexpr auto record (R const& r) {
+		using range = decltype(ranger::range(r));
+		return Record<range, E...>{ranger::range(r)};
+	}
+
 	// rvalue references wrappers
-	template <typename E, bool BE = false, typename R> void place (R&& r, const E e) { place<E, BE, R>(r, e); }
-	template <typename E, bool BE = false, typename R> auto read (R&& r) { return read<E, BE, R>(r); }
-	template <typename E, bool BE = false, typename R> void put (R&& r, const E e) { put<E, BE, R>(r, e); }
+	template <typename E, bool BE = false, typename R> constexpr void place (R&& r, const E e) { place<E, BE, R>(r, e); }
+	template <typename E, bool BE = false, typename R> constexpr auto read (R&& r) { return read<E, BE, R>(r); }
+	template <typename E, bool BE = false, typename R> constexpr void put (R&& r, const E e) { put<E, BE, R>(r, e); }
+	template <typename R> auto bit_writer (R&& r) { return bit_writer<R>(r); }
+	template <typename R> auto bit_reader (R&& r) { return bit_reader<R>(r); }
 }
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <type_traits>
+#include "ranger.hpp"
+
+namespace __ranger {
+	// a vector with inline storage for up to `N` elements,  no allocation
+	// elements are default initialized (not zeroed) up front,  so `T` must be default constructible
+	//
+	// writers target the free part,  then commit what they wrote:
+	//   auto f = v.free();
+	//   serial::put<uint32_t>(f, x);
+	//   v.commit(f);
+	template <typename T, size_t N>
+	struct StaticVector {
+		static_assert(std::is_default_constructible_v<T>, "Expected a default constructible type");
+
+		using value_type = T;
+		using iterator = T*;
+		using const_iterator = T const*;
+
+		T _data[N];
+		size_t _size = 0;
+
+		StaticVector () = default;
+
+		template <typename R>
+		explicit StaticVector (R const& r) {
+			auto const ok = this->put(r);
+			assert(ok);
+			(void) ok;
+		}
+
+		auto data () { return this->_data; }
+		auto data () const { return static_cast<T const*>(this->_data); }
+		auto begin () { return this->data(); }
+		auto begin () const { return this->data(); }
+		auto end () { return this->data() + this->_size; }
+		auto end () const { return this->data() + this->_size; }
+
+		auto size () const { return this->_size; }
+		auto empty () const { return this->_size == 0; }
+		static constexpr auto capacity () { return N; }
+
+		auto& operator[] (size_t const i) {
+			assert(i < this->_size);
+			return this->_data[i];
+		}
+
+		auto const& operator[] (size_t const i) const {
+			assert(i < this->_size);
+			return this->_data[i];
+		}
+
+		// the elements written so far
+		auto filled () { return Range<T*>(this->begin(), this->end()); }
+		auto filled () const { return Range<T const*>(this->begin(), this->end()); }
+
+		// the remaining capacity
+		auto free () { return Range<T*>(this->end(), this->data() + N); }
+
+		// marks the free space before `rest` as written,  `rest` as left by a writer given free()
+		void commit (Range<T*> const rest) {
+			assert(rest.begin() >= this->end() and rest.begin() <= this->data() + N);
+			this->_size = static_cast<size_t>(rest.begin() - this->data());
+		}
+
+		void commit (size_t const n) {
+			assert(this->_size + n <= N);
+			this->_size += n;
+		}
+
+		// appends `e` (an element or a range),  returns false if out of space (writing what fits)
+		template <typename E>
+		auto put (E const& e) {
+			if constexpr(std::is_convertible_v<E, T>) {
+				if (this->_size == N) return false;
+				this->_data[this->_size++] = e;
+				return true;
+			} else {
+				auto const a = ranger::range(e);
+
+				if constexpr(decltype(a)::is_random_access::value) {
+					auto const n = std::min(N - this->_size, a.size());
+					std::copy(a.begin(), a.begin() + static_cast<typename decltype(a)::distance_type>(n), this->end());
+					this->_size += n;
+					return n == a.size();
+				} else {
+					auto f = this->free();
+					auto const ok = f.put(a);
+					this->commit(f);
+					return ok;
+				}
+			}
+		}
+
+		void pop_back () {
+			assert(this->_size > 0);
+			--this->_size;
+		}
+
+		void resize (size_t const n) {
+			assert(n <= N);
+			this->_size = n;
+		}
+
+		void clear () { this->_size = 0; }
+	};
+}
+
+namespace ranger {
+	template <typename T, size_t N> using static_vector_t = __ranger::StaticVector<T, N>;
+}
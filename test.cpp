@@ -1,4 +1,5 @@
 #include <array>
+#include <cmath>
 #include <cstring>
 #include <cstdint>
 #include <forward_list>
@@ -8,12 +9,33 @@
 #include <list>
 #include <map>
 #include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
 #include <type_traits>
+#include <unordered_map>
 #include <vector>
 
+#if __has_include(<sys/wait.h>)
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#define RANGER_DEATH_TESTS
+#endif
+
 #include "ranger.hpp"
 #include "serial.hpp"
 #include "compat.hpp"
+#include "search.hpp"
+#include "hash.hpp"
+#include "numeric.hpp"
+#include "channel.hpp"
+#include "buffer.hpp"
+#include "static_vector.hpp"
+#include "any_range.hpp"
+#include "utf8.hpp"
+#include "encoding.hpp"
+#include "generator.hpp"
 
 using namespace ranger;
 
@@ -41,6 +63,125 @@ auto const S123456 = std::array{1, 2, 3, 4, 5, 6};
 auto const S1234567 = std::array{1, 2, 3, 4, 5, 6, 7};
 auto const TQBFJ = zstr_range("the quick brown fox jumped");
 
+// constant expressions
+constexpr auto CTABLE = std::array{1, 3, 5, 7, 11};
+constexpr auto CBYTES = std::array<uint8_t, 4>{0x01, 0x02, 0x03, 0x04};
+
+static_assert(range(CTABLE).size() == 5);
+static_assert(range(CTABLE).drop(1).take(2).front() == 3);
+static_assert(range(CTABLE).back() == 11);
+static_assert(range(CTABLE)[2] == 5);
+static_assert(reverse(CTABLE).front() == 11);
+static_assert(prefetch(CTABLE).drop(1).front() == 3);
+static_assert(prefetch(CTABLE, 2).size() == 5);
+static_assert(range(CTABLE).count([](auto x) { return x > 4; }) == 3);
+static_assert(range(CTABLE).contains(range(CTABLE).drop(3)));
+static_assert(ordered(CTABLE).contains(7));
+static_assert(not ordered(CTABLE).contains(4));
+static_assert(*ordered(CTABLE).lower_bound(4) == 5);
+static_assert(*ordered(CTABLE).upper_bound(5) == 7);
+static_assert(zstr_range("hello").size() == 5);
+static_assert(zstr_range("hello").starts_with(zstr_range("he")));
+static_assert(zstr_range("hello").ends_with(zstr_range("llo")));
+static_assert(serial::peek<uint32_t>(CBYTES) == 0x04030201);
+static_assert(serial::peek<uint16_t, true>(CBYTES) == 0x0102);
+static_assert(serial::peek<int8_t>(range(CBYTES).drop(3)) == 4);
+
+constexpr auto encoded () {
+	auto a = std::array<uint8_t, 6>{};
+	auto r = range(a);
+	serial::put<uint32_t, true>(r, 0xdeadbeef);
+	serial::put<int16_t>(r, -2);
+	return a;
+}
+
+static_assert(serial::peek<uint32_t, true>(encoded()) == 0xdeadbeef);
+static_assert(serial::peek<int16_t>(range(encoded()).drop(4)) == -2);
+
+// back() and pop_back() only for bidirectional ranges
+template <typename R, typename = void>
+struct has_back : std::false_type {};
+
+template <typename R>
+struct has_back<R, std::void_t<decltype(std::declval<R&>().back())>> : std::true_type {};
+
+template <typename R, typename = void>
+struct has_pop_back : std::false_type {};
+
+template <typename R>
+struct has_pop_back<R, std::void_t<decltype(std::declval<R&>().pop_back())>> : std::true_type {};
+
+static_assert(has_back<range_t<std::list<int>::iterator>>::value);
+static_assert(has_pop_back<range_t<std::list<int>::iterator>>::value);
+static_assert(not has_back<range_t<std::forward_list<int>::iterator>>::value);
+static_assert(not has_back<sized_range_t<std::list<int>::iterator>>::value);
+static_assert(not has_back<sized_range_t<std::list<int>::iterator> const>::value);
+static_assert(not has_pop_back<sized_range_t<std::list<int>::iterator>>::value);
+
+#ifdef RANGER_DEATH_TESTS
+// runs `f` in a child process,  true if it was killed by a signal (a trap)
+template <typename F>
+bool traps (F const f) {
+	auto const pid = fork();
+	if (pid == 0) {
+		auto const none = rlimit{0, 0};
+		setrlimit(RLIMIT_CORE, &none);
+		f();
+		_exit(0);
+	}
+
+	int status = 0;
+	waitpid(pid, &status, 0);
+	return WIFSIGNALED(status);
+}
+#endif
+
+// coroutines
+#ifdef RANGER_GENERATOR
+static size_t generator_frames = 0;
+
+template <typename T>
+struct CountingAllocator {
+	using value_type = T;
+
+	CountingAllocator () = default;
+	template <typename U> CountingAllocator (CountingAllocator<U> const&) {}
+
+	T* allocate (size_t const n) {
+		++generator_frames;
+		return std::allocator<T>().allocate(n);
+	}
+
+	void deallocate (T* const p, size_t const n) {
+		--generator_frames;
+		std::allocator<T>().deallocate(p, n);
+	}
+};
+
+generator<int> iota (int const n) {
+	for (int i = 1; i <= n; ++i) co_yield i;
+}
+
+generator<int, CountingAllocator<std::byte>> counted_iota (int const n) {
+	for (int i = 1; i <= n; ++i) co_yield i;
+}
+
+generator<std::string> words (std::string const s) {
+	auto word = std::string{};
+	for (auto const c : s) {
+		if (c != ' ') {
+			word += c;
+			continue;
+		}
+
+		co_yield word;
+		word.clear();
+	}
+
+	co_yield word;
+}
+#endif
+
 int main () {
 describe("drop / take", [&](auto test) {
 	test(range(S1234567).drop(0).size() == 7 - 0);
@@ -76,6 +217,20 @@ describe("size", [&](auto test) {
 	test(range(S123456).size() == 6);
 });
 
+describe("front / back / operator[]", [&](auto test) {
+	auto a = range(S1234);
+	test(a.front() == 1);
+	test(a.back() == 4);
+	test(a[0] == 1);
+	test(a[3] == 4);
+	test(reverse(S1234).back() == 1);
+	test(reverse(S1234)[1] == 3);
+
+	auto l = std::list<int>{1, 2, 3};
+	test(range(l).back() == 3);
+	test(range(l).drop_back(1).back() == 2);
+});
+
 describe("operators", [&](auto test) {
 	auto const a = range(S1234);
 	auto const b = range(std::array{1, 2, 3, 5});
@@ -301,6 +456,144 @@ describe("serial", [](auto test) {
 	test(memcmp(expected.data(), actual.data(), actual.size()) == 0);
 });
 
+describe("checksums", [](auto test) {
+	auto const check = zstr_range("123456789");
+	auto const bytes = std::vector<uint8_t>(check.begin(), check.end());
+	auto const list = std::list<uint8_t>(check.begin(), check.end());
+
+	test(serial::crc32c(check) == 0xE3069283);
+	test(serial::crc32c(bytes) == 0xE3069283);
+	test(serial::crc32c(list) == 0xE3069283);
+	test(serial::crc32c(zstr_range("")) == 0);
+	test(serial::crc32c(range(bytes).drop(4), serial::crc32c(range(bytes).take(4))) == 0xE3069283);
+	test(serial::crc32c_table8(~0u, bytes.data(), bytes.size()) == ~0xE3069283u);
+
+	auto big = std::vector<uint8_t>(10000);
+	for (size_t i = 0; i < big.size(); ++i) big[i] = static_cast<uint8_t>(i * 7);
+	test(serial::crc32c(big) == serial::crc32c(std::list<uint8_t>(big.begin(), big.end())));
+
+	// contiguous containers take the pointer (SSE4.2 or slicing-by-8) path,  at any alignment
+	auto const text = std::string(big.begin(), big.end());
+	auto const slow = std::list<uint8_t>(big.begin(), big.end());
+	static_assert(std::is_pointer_v<decltype(contiguous_range(text))::iterator>);
+	static_assert(std::is_pointer_v<decltype(contiguous_range(big))::iterator>);
+	for (size_t offset : {0, 1, 3, 7}) {
+		auto const expected = serial::crc32c(range(slow).drop(offset));
+		test(serial::crc32c(std::vector<uint8_t>(big.begin() + static_cast<std::ptrdiff_t>(offset), big.end())) == expected);
+		test(serial::crc32c(text.substr(offset)) == expected);
+		test(serial::crc32c(ptr_range(text).drop(offset)) == expected);
+	}
+	test(serial::crc32c(text) == ~serial::crc32c_table8(~0u, big.data(), big.size()));
+	test(serial::adler32(text) == serial::adler32(slow));
+
+	test(serial::adler32(zstr_range("Wikipedia")) == 0x11E60398);
+	test(serial::adler32(zstr_range("")) == 1);
+	test(serial::adler32(big) == serial::adler32(range(big).drop(5000), serial::adler32(range(big).take(5000))));
+
+	// verifying reader
+	auto frame = std::array<uint8_t, 10>{};
+	auto w = range(frame);
+	serial::put<uint16_t>(w, 0xbeef);
+	serial::put<uint32_t, true>(w, 0x01020304);
+	serial::put<uint32_t>(w, serial::crc32c(range(frame).take(6)));
+
+	auto reader = serial::crc32c_reader(frame);
+	static_assert(std::is_pointer_v<decltype(reader.range())::iterator>);
+	test(reader.read<uint16_t>() == 0xbeef);
+	test(reader.read<uint32_t, true>() == 0x01020304);
+	auto const crc = reader.crc();
+	test(reader.verify(serial::read<uint32_t>(range(frame).drop(6))));
+	test(serial::peek<uint32_t>(reader.range()) == crc);
+	test(reader.take(4).size() == 4);
+	test(reader.empty());
+});
+
+describe("bit packing", [](auto test) {
+	auto buffer = std::array<uint8_t, 16>{};
+	auto w = serial::bit_writer(buffer);
+	test(w.write(5, 3));
+	test(w.write(0, 1));
+	test(w.write(0xabcd, 16));
+	test(w.write(0xffffffff, 32));
+	test(w.write(1, 1));
+	test(w.flush());
+	test(w.range().size() == 16 - 7);
+	test(buffer[0] == (5 | (0xd << 4)));
+
+	auto r = serial::bit_reader(range(buffer).take(7));
+	test(r.read(3) == 5);
+	test(r.read(1) == 0);
+	test(r.read(16) == 0xabcd);
+	test(r.read(32) == 0xffffffff);
+	test(r.read(1) == 1);
+	test(not r.overrun());
+	test(r.read(8) == 0);
+	test(r.overrun());
+
+	auto full = std::array<uint8_t, 1>{};
+	auto fw = serial::bit_writer(full);
+	test(fw.write(0xff, 8));
+	test(not fw.write(0xff, 8));
+
+	// frame-of-reference blocks
+	auto values = std::vector<uint32_t>(256);
+	for (size_t i = 0; i < values.size(); ++i) values[i] = 1000 + static_cast<uint32_t>((i * 37) % 101);
+	test(serial::bit_width(values, 1000) == 7);
+
+	for (unsigned bits : {0u, 1u, 7u, 13u, 31u, 32u}) {
+		auto const base = bits == 0 ? 5u : 0u;
+		auto input = std::vector<uint32_t>(256);
+		for (size_t i = 0; i < input.size(); ++i) {
+			auto const mask = bits == 32 ? ~0u : (1u << bits) - 1;
+			input[i] = base + (static_cast<uint32_t>(i * 2654435761u) & mask);
+		}
+
+		auto packed = std::vector<uint8_t>(serial::packed_size<256>(bits) + 3);
+		auto out = ptr_range(packed);
+		test(serial::pack<256>(input, base, bits, out));
+		test(out.size() == 3);
+
+		auto decoded = std::vector<uint32_t>(256);
+		auto in = ptr_range(packed);
+		test(serial::unpack<256>(in, base, bits, decoded));
+		test(in.size() == 3);
+		test(decoded == input);
+
+		auto half = std::vector<uint32_t>(128);
+		auto in128 = ptr_range(packed);
+		test(serial::pack<128>(input, base, bits, in128));
+		in128 = ptr_range(packed);
+		test(serial::unpack<128>(in128, base, bits, half));
+		test(range(half) == range(input).take(128));
+	}
+
+	auto small = std::vector<uint8_t>(4);
+	auto so = ptr_range(small);
+	test(not serial::pack<128>(values, 1000, 7, so)); // out too small
+	test(so.size() == 4);
+
+	// out of range values are rejected,  not spilled into their neighbours
+	for (auto const bad : {1000u + 128u, 999u}) {
+		auto input = std::vector<uint32_t>(values.begin(), values.begin() + 128);
+		input[1] = bad;
+
+		auto packed = std::vector<uint8_t>(serial::packed_size<128>(7), 0xAA);
+		auto out = ptr_range(packed);
+		test(not serial::pack<128>(input, 1000, 7, out));
+		test(out.size() == packed.size());
+		test(std::count(packed.begin(), packed.end(), 0xAA) == 128 * 7 / 8);
+
+		// masked to the width by the caller,  the neighbours round trip
+		input[1] = 1000 + ((bad - 1000) & 0x7F);
+		test(serial::pack<128>(input, 1000, 7, out));
+		auto in = ptr_range(packed);
+		auto decoded = std::vector<uint32_t>(128);
+		test(serial::unpack<128>(in, 1000, 7, decoded));
+		test(decoded == input);
+		test(decoded[5] == values[5]);
+	}
+});
+
 describe("other containers", [](auto) {
 	describe("map", [](auto test) {
 		auto map = std::map<char, int>{};
@@ -352,6 +645,726 @@ describe("other containers", [](auto) {
 	});
 });
 
+describe("sized_range", [](auto test) {
+	auto l = std::list<int>{1, 2, 3, 4, 5, 6};
+	auto a = sized(l);
+	test(a.size() == 6);
+	test(not a.empty());
+	test(a == S123456);
+	test(a.take(3) == S123);
+	test(a.take(3).size() == 3);
+	test(a.take(10).size() == 6);
+	test(a.take(4).drop(1) == range(S1234).drop(1));
+	test(a.take(4).drop(1).size() == 3);
+	test(a.drop(10).empty());
+	test(a.drop(6).size() == 0);
+	test(a.take(0).empty());
+
+	auto b = a;
+	auto bf = b.pop_front(2);
+	test(bf.size() == 2);
+	test(bf == range(S123456).take(2));
+	test(b.size() == 4);
+	test(b.front() == 3);
+	b.pop_front();
+	test(b.front() == 4);
+
+	auto f = std::forward_list<int>{1, 2, 3};
+	auto c = sized(f);
+	test(c.size() == 3);
+	test(c.take(2) == range(S123).take(2));
+	test(c.drop(1).take(1).front() == 2);
+
+	auto cf = c;
+	test(cf.pop_front().size() == 1);
+	test(cf.size() == 2);
+	test(cf.front() == 2);
+	test(cf.pop_front(10).size() == 2);
+	test(cf.size() == 0);
+	test(cf.empty());
+	test(c.size() == 3);
+	static_assert(not has_pop_back<decltype(c)>::value);
+
+	auto d = counted(l.begin(), 4);
+	test(d == S1234);
+	test(d.count([](auto x) { return x > 2; }) == 2);
+
+	auto out = std::vector<int>(6);
+	range(out).put(a.take(3));
+	test(range(out).take(3) == S123);
+
+	for (size_t n = 0; n <= 7; ++n) {
+		for (size_t m = 0; m <= 7; ++m) {
+			auto const e = range(S123456).take(n).drop(m);
+			auto const x = sized(l).take(n).drop(m);
+			test(x.size() == e.size());
+			test(x.empty() == e.empty());
+			test(x == e);
+		}
+	}
+});
+
+describe("chain", [](auto test) {
+	auto const b0 = std::vector<uint8_t>{1, 2, 3};
+	auto const b1 = std::vector<uint8_t>{};
+	auto const b2 = std::vector<uint8_t>{4, 5};
+	auto const b3 = std::vector<uint8_t>{6, 7, 8, 9};
+	auto const segments = std::vector<range_t<uint8_t const*>>{ptr_range(b0), ptr_range(b1), ptr_range(b2), ptr_range(b3)};
+
+	auto const c = chain(segments);
+	auto const all = std::vector<uint8_t>{1, 2, 3, 4, 5, 6, 7, 8, 9};
+	test(c == all);
+	test(c.size() == 9);
+	test(c.drop(2) == range(all).drop(2));
+	test(c.drop(3).front() == 4);
+	test(c.drop(2).take(4) == range(all).drop(2).take(4));
+	test(c.drop(2).take(4).size() == 4);
+	test(c.drop(20).empty());
+	test(c.take(20).size() == 9);
+	test(c.drop(4).segment() == std::vector<uint8_t>{5});
+	test(c.drop(5).take(2).segment() == std::vector<uint8_t>{6, 7});
+
+	size_t n = 0;
+	c.drop(1).take(6).each_segment([&](auto) { return ++n; });
+	test(n == 3);
+
+	test(c.count([](auto x) { return x % 2 == 0; }) == 4);
+	test(c.drop(2).take(5).count([](auto x) { return x % 2 == 0; }) == 2);
+
+	test(c.contains(std::vector<uint8_t>{7, 8}));
+	test(c.contains(std::vector<uint8_t>{3, 4, 5, 6})); // straddles two boundaries (and an empty segment)
+	test(c.contains(std::vector<uint8_t>{5, 6}));
+	test(not c.contains(std::vector<uint8_t>{3, 5}));
+	test(not c.take(5).contains(std::vector<uint8_t>{5, 6}));
+	test(not c.drop(3).contains(std::vector<uint8_t>{3, 4}));
+
+	// serial::read across a boundary
+	auto r = c;
+	test(serial::read<uint16_t>(r) == 0x0201);
+	test(serial::read<uint16_t>(r) == 0x0403);
+	test((serial::read<uint32_t, true>(r) == 0x05060708));
+	test(r.size() == 1);
+	test(serial::read<uint8_t>(r) == 9);
+	test(r.empty());
+
+	// put from,  and into a chain
+	auto out = std::vector<uint8_t>(9);
+	auto o = range(out);
+	test(o.put(c));
+	test(out == all);
+	test(not range(out).take(5).put(c));
+
+	auto w0 = std::vector<uint8_t>(2);
+	auto w1 = std::vector<uint8_t>(5);
+	auto writable = std::vector<range_t<uint8_t*>>{ptr_range(w0), ptr_range(w1)};
+	auto d = chain(writable);
+	test(d.put(uint8_t(7)));
+	test(d.put(std::list<uint8_t>{1, 2, 3}));
+	serial::put<uint16_t>(d, 0x0504);
+	test(d.size() == 1);
+	test(not d.put(std::vector<uint8_t>{8, 9}));
+	test(w0 == std::vector<uint8_t>{7, 1});
+	test(w1 == std::vector<uint8_t>{2, 3, 4, 5, 8});
+	test(d.empty());
+
+	// segments with data(),  searched and copied as pointer ranges
+	auto vectors = std::vector<std::vector<uint8_t>>{b0, b1, b2, b3};
+	auto const v = chain(vectors);
+	static_assert(std::is_same_v<decltype(v.contiguous_segment()), range_t<uint8_t*>>);
+	test(v.drop(4).contiguous_segment().begin() == vectors[2].data() + 1);
+	test(v.drop(5).take(2).contiguous_segment() == std::vector<uint8_t>{6, 7});
+	test(v.contains(std::vector<uint8_t>{7, 8}));
+	test(v.contains(std::string("\x03\x04\x05\x06")));
+	test(not v.contains(std::vector<uint8_t>{3, 5}));
+	test(not v.drop(3).contains(std::vector<uint8_t>{3, 4}));
+
+	std::fill(out.begin(), out.end(), uint8_t(0));
+	o = range(out);
+	test(o.put(v.drop(1)));
+	test(o.size() == 1);
+	test(range(out).take(8) == range(all).drop(1));
+
+	auto const vw = chain(vectors);
+	auto vo = vw.drop(2);
+	test(vo.put(std::vector<uint8_t>{9, 8, 7}));
+	test(vectors[0] == std::vector<uint8_t>{1, 2, 9});
+	test(vectors[2] == std::vector<uint8_t>{8, 7});
+
+	auto nested = std::list<std::vector<int>>{{1, 2}, {}, {3}, {4, 5, 6}};
+	test(chain(nested) == S123456);
+	test(chain(nested).drop(1).take(3) == range(S123456).drop(1).take(3));
+});
+
+describe("buffer", [](auto test) {
+	auto b = buffer_t<>(8);
+	test(b.empty());
+	test(b.free().empty());
+
+	// committing before the first chunk,  nothing written
+	auto nf = b.free();
+	test(nf.empty());
+	b.commit(nf);
+	b.commit(0);
+	test(b.reserve(0).empty());
+	b.commit(b.reserve(0));
+	test(b.empty());
+	test(b.segments().empty());
+
+	auto f = b.reserve(6);
+	test(f.size() == 8);
+	serial::put<uint32_t>(f, 0x04030201);
+	b.commit(f);
+	test(b.size() == 4);
+	test(b.free().size() == 4);
+
+	// too large for the current chunk,  the written bytes stay where they are
+	auto const first = b.segments()[0].begin();
+	f = b.reserve(6);
+	test(f.size() == 8);
+	serial::put<uint16_t>(f, 0x0605);
+	b.commit(f);
+	test(b.segments()[0].begin() == first);
+	test(b.segments().size() == 2);
+
+	b.put(std::vector<uint8_t>{7, 8, 9, 10, 11, 12, 13, 14, 15});
+	b.put(std::list<uint8_t>{16, 17});
+	test(b.size() == 17);
+	test(b.segments().size() == 3);
+
+	auto const segments = b.segments();
+	auto c = chain(segments);
+	test(serial::read<uint32_t>(c) == 0x04030201);
+	test(c.front() == 5);
+	test(c.drop(11).front() == 16);
+	test(c.size() == 13);
+
+#ifdef RANGER_IOVEC
+	auto const iov = b.iovecs();
+	test(iov.size() == 3);
+	test(iov[0].iov_len == 4);
+	test(iov[1].iov_len == 8);
+	test(iov[2].iov_len == 5);
+#endif
+
+	// compat writers into char buffers
+	auto t = buffer_t<char>(16);
+	auto tf = t.reserve(8);
+	test(compat::put_to_chars(tf, 1234));
+	t.commit(tf);
+	t.put(std::string(" abc"));
+	test(t.segments()[0] == std::string("1234 abc"));
+
+	b.clear();
+	test(b.empty());
+	test(b.segments().empty());
+	b.put(std::vector<uint8_t>{1, 2});
+	test(b.segments()[0].begin() == first); // reused
+});
+
+describe("static_vector", [](auto test) {
+	auto v = static_vector_t<int, 6>{};
+	test(v.empty());
+	test(v.capacity() == 6);
+	test(v.free().size() == 6);
+
+	test(v.put(1));
+	test(v.put(std::vector<int>{2, 3}));
+	test(v.put(std::list<int>{4}));
+	test(v.size() == 4);
+	test(v.filled() == S1234);
+	test(ptr_range(v) == S1234);
+	test(v[3] == 4);
+
+	test(not v.put(S123)); // writes what fits
+	test(v.size() == 6);
+	test(range(v) == std::vector<int>{1, 2, 3, 4, 1, 2});
+	test(not v.put(9));
+	test(v.free().empty());
+
+	v.pop_back();
+	v.resize(2);
+	test(range(v) == range(S123).take(2));
+	v.clear();
+	test(v.empty());
+
+	auto const w = static_vector_t<int, 8>(S1234);
+	test(w.filled() == S1234);
+	test(w.filled().sum() == 10);
+
+	// serial and compat writers
+	auto bytes = static_vector_t<uint8_t, 16>{};
+	auto f = bytes.free();
+	serial::put<uint32_t>(f, 0x04030201);
+	serial::put<uint16_t, true>(f, 0x0506);
+	bytes.commit(f);
+	test(bytes.size() == 6);
+	test(range(bytes) == std::vector<uint8_t>{1, 2, 3, 4, 5, 6});
+
+	auto chars = static_vector_t<char, 8>{};
+	auto cf = chars.free();
+	test(compat::put_to_chars(cf, -42));
+	chars.commit(cf);
+	test(range(chars) == std::string("-42"));
+	test(not chars.put(std::string("123456")));
+	test(range(chars) == std::string("-4212345"));
+});
+
+describe("any_range", [](auto test) {
+	// across a non-template boundary
+	struct Sink {
+		static long total (any_range_t<int>& r) {
+			long result = 0;
+			r.each_batch([&](auto const batch) { result += batch.sum(); });
+			return result;
+		}
+	};
+
+	auto v = std::vector<int>(1000);
+	for (size_t i = 0; i < v.size(); ++i) v[i] = static_cast<int>(i);
+
+	auto a = any_range<int>(v);
+	test(a.contiguous().has_value());
+	test(a.contiguous()->begin() == v.data());
+	test(Sink::total(a) == 499500);
+	test(a.empty());
+
+	auto l = std::list<int>(v.begin(), v.end());
+	auto b = any_range<int>(l);
+	test(not b.contiguous());
+	test(Sink::total(b) == 499500);
+	test(b.empty());
+
+	auto c = any_range<int>(reverse(S123456));
+	auto out = std::vector<int>(4);
+	test(c.next_batch(ptr_range(out)) == 4);
+	test(out == std::vector<int>{6, 5, 4, 3});
+	test(c.next_batch(ptr_range(out)) == 2);
+	test(range(out).take(2) == std::vector<int>{2, 1});
+	test(c.next_batch(ptr_range(out)) == 0);
+
+	auto d = any_range<int>(ptr_range(S123456).drop(1));
+	d.pop_front(2);
+	test(*d.contiguous() == range(S123456).drop(3));
+
+	auto const bytes = std::vector<uint8_t>{1, 2, 3};
+	auto e = any_range<long>(bytes); // converting
+	test(not e.contiguous());
+	long se = 0;
+	e.each_batch([&](auto const batch) { se += batch.sum(); });
+	test(se == 6);
+
+	auto stream = std::stringstream{"5 7 9"};
+	auto f = any_range<int>(input_range(std::istream_iterator<int>{stream}));
+	test(not f.empty());
+	f.pop_front();
+	test(f.next_batch(ptr_range(out)) == 2);
+	test(range(out).take(2) == std::vector<int>{7, 9});
+	test(f.empty());
+});
+
+describe("utf8", [](auto test) {
+	using namespace ranger::utf8;
+
+	auto const ascii = std::string("the quick brown fox jumps over the lazy dog");
+	auto const mixed = std::string("a\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80z"); // a é € 😀 z
+	test(validate(ascii));
+	test(validate(mixed));
+	test(validate(ptr_range(ascii).take(0)));
+	test(validate(zstr_range("plain")));
+
+	auto const bad = [&](std::string const s) { return not validate(s); };
+	test(bad("\x80"));
+	test(bad("\xC0\xAF")); // overlong
+	test(bad("\xE0\x80\xAF")); // overlong
+	test(bad("\xED\xA0\x80")); // surrogate
+	test(bad("\xF4\x90\x80\x80")); // > U+10FFFF
+	test(bad("\xF5\x80\x80\x80"));
+	test(bad("\xE2\x82")); // truncated
+	test(bad(ascii + "\xFF" + ascii));
+	test(valid_prefix(ascii + "\xE2\x82") == ascii.size());
+	test(valid_prefix(mixed) == mixed.size());
+
+	auto const cps = code_points(mixed);
+	test(cps == std::u32string(U"a\u00E9\u20AC\U0001F600z"));
+	test(code_points(std::string("a\xFF" "b")) == std::u32string(U"a\uFFFDb"));
+	test(code_points(std::string("")).empty());
+
+	test(utf32_length(mixed) == 5);
+	test(utf16_length(mixed) == 6);
+
+	auto out32 = std::u32string(5, U'\0');
+	auto in = ptr_range(mixed);
+	auto o32 = ptr_range(out32);
+	test(to_utf32(in, o32));
+	test(in.empty());
+	test(o32.empty());
+	test(out32 == U"a\u00E9\u20AC\U0001F600z");
+
+	auto out16 = std::u16string(6, u'\0');
+	in = ptr_range(mixed);
+	auto o16 = ptr_range(out16);
+	test(to_utf16(in, o16));
+	test(out16 == u"a\u00E9\u20AC\U0001F600z");
+
+	// stops before a surrogate pair that doesn't fit
+	in = ptr_range(mixed);
+	o16 = ptr_range(out16).take(4);
+	test(not to_utf16(in, o16));
+	test(in.size() == 5);
+	test(o16.empty() == false);
+
+	// stops at the invalid sequence
+	auto const broken = ascii + "\xC3" + ascii;
+	auto out = std::vector<uint32_t>(broken.size());
+	auto bi = ptr_range(broken);
+	auto bo = ptr_range(out);
+	test(not to_utf32(bi, bo));
+	test(bi.size() == ascii.size() + 1);
+	test(bo.size() == broken.size() - ascii.size());
+
+	// non random access output
+	auto l = std::list<char32_t>(3);
+	auto li = ptr_range(mixed);
+	auto lo = range(l);
+	test(not to_utf32(li, lo));
+	test(li.size() == mixed.size() - 6);
+	test(l == std::list<char32_t>{U'a', U'\u00E9', U'\u20AC'});
+});
+
+describe("encoding", [](auto) {
+	describe("hex", [](auto test) {
+		auto const bytes = std::vector<uint8_t>{0x00, 0x01, 0x7f, 0x80, 0xab, 0xff, 0x10, 0x20, 0x30, 0x40, 0xde};
+		auto text = std::string(hex::encoded_size(bytes.size()), '\0');
+
+		auto in = ptr_range(bytes);
+		auto out = ptr_range(text);
+		test(hex::encode(in, out));
+		test(in.empty());
+		test(out.empty());
+		test(text == "00017f80abff1020304" "0de");
+
+		auto upper = std::string(22, '\0');
+		in = ptr_range(bytes);
+		auto uo = ptr_range(upper);
+		test(hex::encode(in, uo, true));
+		test(upper == "00017F80ABFF1020304" "0DE");
+
+		auto small = std::string(3, '\0');
+		in = ptr_range(bytes);
+		auto so = ptr_range(small);
+		test(not hex::encode(in, so));
+		test(in.size() == bytes.size());
+
+		auto decoded = std::vector<uint8_t>(hex::decoded_size(upper));
+		auto ti = ptr_range(upper);
+		auto dout = ptr_range(decoded);
+		test(hex::decode(ti, dout));
+		test(ti.empty());
+		test(decoded == bytes);
+
+		// errors,  `in` left at the bad character
+		auto const bad = std::string("00112233445566778899aabbccddeeffx0");
+		auto bi = ptr_range(bad);
+		auto bd = std::vector<uint8_t>(17);
+		auto bo = ptr_range(bd);
+		test(not hex::decode(bi, bo));
+		test(bi.size() == 2);
+		test(bi.front() == 'x');
+		test(bo.size() == 1);
+		test(bd[15] == 0xff);
+
+		auto const bad2 = std::string("0g");
+		auto b2 = ptr_range(bad2);
+		auto b2o = ptr_range(bd);
+		test(not hex::decode(b2, b2o));
+		test(b2.front() == 'g');
+
+		auto const odd = std::string("abc");
+		auto oi = ptr_range(odd);
+		auto oo = ptr_range(bd);
+		test(not hex::decode(oi, oo));
+		test(oi.size() == 1);
+		test(bd[0] == 0xab);
+	});
+
+	describe("base64", [](auto test) {
+		auto const roundtrip = [&](std::string const plain, std::string const encoded) {
+			auto text = std::string(base64::encoded_size(plain.size()), '\0');
+			auto in = ptr_range(plain);
+			auto out = ptr_range(text);
+			test(base64::encode(in, out));
+			test(out.empty());
+			test(text == encoded);
+
+			test(base64::decoded_size(ptr_range(encoded)) == plain.size());
+			auto decoded = std::string(plain.size(), '\0');
+			auto ei = ptr_range(encoded);
+			auto dout = ptr_range(decoded);
+			test(base64::decode(ei, dout));
+			test(ei.empty());
+			test(dout.empty());
+			test(decoded == plain);
+		};
+
+		// RFC 4648
+		roundtrip("", "");
+		roundtrip("f", "Zg==");
+		roundtrip("fo", "Zm8=");
+		roundtrip("foo", "Zm9v");
+		roundtrip("foob", "Zm9vYg==");
+		roundtrip("fooba", "Zm9vYmE=");
+		roundtrip("foobar", "Zm9vYmFy");
+		roundtrip(std::string("\x00\xff\xfe", 3), "AP/+");
+
+		auto const fail_at = [&](std::string const encoded, size_t const at, size_t const written) {
+			auto decoded = std::string(16, '\0');
+			auto ei = ptr_range(encoded);
+			auto dout = ptr_range(decoded);
+			test(not base64::decode(ei, dout));
+			test(ei.size() == encoded.size() - at);
+			test(dout.size() == decoded.size() - written);
+		};
+
+		fail_at("Zm9v!m9v", 4, 3);
+		fail_at("Zm9vZm9", 4, 3); // incomplete
+		fail_at("Zg==Zm9v", 2, 0); // padding before the end
+		fail_at("Zm=v", 2, 0);
+		fail_at("Z===", 1, 0);
+
+		// non-canonical,  non-zero bits before the padding
+		fail_at("Zh==", 1, 0);
+		fail_at("Zm9=", 2, 0);
+		fail_at("Zm9vZh==", 5, 3);
+
+		// decode fused with serial::read
+		auto const encoded = std::string("AQIDBA==");
+		auto buffer = std::array<uint8_t, 4>{};
+		auto ei = ptr_range(encoded);
+		auto dout = ptr_range(buffer);
+		test(base64::decode(ei, dout));
+		auto r = ptr_range(buffer);
+		test(serial::read<uint32_t>(r) == 0x04030201);
+
+		auto small = std::array<uint8_t, 3>{};
+		ei = ptr_range(encoded);
+		auto so = ptr_range(small);
+		test(not base64::decode(ei, so));
+		test(ei.size() == encoded.size());
+	});
+});
+
+describe("frames", [](auto test) {
+	auto buffer = std::vector<uint8_t>(64);
+	auto w = ptr_range(buffer);
+	auto const frame = [&](std::vector<uint8_t> const& body) {
+		serial::put<uint16_t, true>(w, static_cast<uint16_t>(body.size()));
+		w.put(ptr_range(body));
+	};
+
+	frame({1, 2, 3});
+	frame({});
+	frame({4, 5});
+	auto const used = buffer.size() - w.size();
+	auto const data = ptr_range(buffer).take(used);
+
+	auto const f = serial::frames<uint16_t, true>(data);
+	test(std::distance(f.begin(), f.end()) == 3);
+	test(f.front() == S123);
+	test(f.front().begin() == data.begin() + 2); // not copied
+	test(f.drop(1).front().empty());
+	test(f.drop(2).front() == std::vector<uint8_t>{4, 5});
+	test(f.count([](auto const& x) { return x.size() > 1; }) == 2);
+
+	// truncated
+	auto const truncated = data.take(used - 1);
+	auto it = serial::frames<uint16_t, true>(truncated).begin();
+	size_t n = 0;
+	for (; it != decltype(it)(); ++it) ++n;
+	test(n == 2);
+	test(it.rest().size() == 3);
+	test(serial::frames<uint16_t, true>(data.take(1)).empty());
+
+	auto r = data;
+	test(serial::read_frame<uint16_t, true>(r) == std::optional(data.drop(2).take(3)));
+	test(r.size() == 6);
+	test(serial::read_frame<uint16_t, true>(r)->empty());
+	auto short_ = r.take(3);
+	test(not serial::read_frame<uint16_t, true>(short_));
+	test(short_.size() == 3);
+
+	// little endian 32-bit prefixes
+	auto const le = std::vector<uint8_t>{2, 0, 0, 0, 9, 8, 1, 0, 0, 0, 7};
+	auto const g = serial::frames<uint32_t>(le);
+	test(std::distance(g.begin(), g.end()) == 2);
+	test(g.drop(1).front() == std::vector<uint8_t>{7});
+});
+
+describe("record", [](auto test) {
+	auto buffer = std::vector<uint8_t>(16);
+	auto w = ptr_range(buffer);
+	serial::put<uint32_t>(w, 0xdeadbeef);
+	serial::put<uint16_t>(w, 513);
+	serial::put<uint8_t>(w, 7);
+	serial::put<uint64_t, true>(w, 0x0102030405060708);
+	w.put(uint8_t(42));
+
+	auto const rec = serial::record<uint32_t, uint16_t, uint8_t, uint64_t>(buffer);
+	static_assert(decltype(rec)::size == 15);
+	static_assert(decltype(rec)::offset<3>() == 7);
+	test(rec.valid());
+	test(rec.get<0>() == 0xdeadbeef);
+	test(rec.get<1>() == 513);
+	test(rec.get<2>() == 7);
+	test((rec.get<3, true>() == 0x0102030405060708));
+	test(rec.rest().size() == 1);
+	test(rec.rest().front() == 42);
+
+	test(not serial::record<uint64_t, uint64_t>(ptr_range(buffer).take(15)).valid());
+
+	constexpr auto header = std::array<uint8_t, 4>{1, 0, 2, 0};
+	static_assert(serial::record<uint16_t, uint16_t>(header).get<1>() == 2);
+});
+
+#ifdef RANGER_GENERATOR
+describe("generator", [](auto test) {
+	auto g = iota(6);
+	auto a = input_range(g.begin());
+	test(a == S123456);
+	test(a.empty()); // the iterators share the coroutine,  no cached value
+
+	auto h = iota(10);
+	auto b = input_range(h.begin());
+	b.pop_until([](auto x) { return x > 3; });
+	test(b.front() == 4);
+	test(b.count([](auto x) { return x % 2 == 0; }) == 4); // 4, 6, 8, 10
+
+	auto k = iota(5);
+	test(range(k).any([](auto x) { return x == 5; }));
+
+	auto w = words("the quick brown fox");
+	int n = 0;
+	for (auto const& x : w) n += static_cast<int>(x.size());
+	test(n == 16);
+
+	{
+		auto c = counted_iota(3);
+		test(generator_frames == 1);
+		test(input_range(c.begin()) == S123);
+	}
+	test(generator_frames == 0);
+
+	auto e = iota(0);
+	test(input_range(e.begin()).empty());
+});
+
+#endif
+
+describe("prefetch", [](auto test) {
+	auto m = std::vector<std::pair<int, int>>{};
+	for (int i = 0; i < 100; ++i) m.emplace_back(i, i * 2);
+
+	auto const a = prefetch(m);
+	test(a == range(m));
+	test(a.size() == 100);
+	test(a.front().second == 0);
+	test(a.back().second == 198);
+	test(a.drop(98).front().first == 98);
+
+	int total = 0;
+	for (auto const& kv : prefetch(m, 3)) total += kv.second;
+	test(total == 9900);
+
+	test(prefetch(S123456, 100) == S123456);
+	test(prefetch(S123456, 0) == S123456);
+	test(prefetch(S123456).take(3) == S123);
+
+	auto v = std::vector<int>{6, 5, 4, 3, 2, 1};
+	auto b = prefetch(v, 2);
+	static_assert(std::is_same_v<decltype(b.begin())::iterator_category, std::random_access_iterator_tag>);
+	test(b.size() == 6);
+	test(b[2] == 4);
+	test(b.drop(2).take(2) == range(v).drop(2).take(2));
+	test(b.end() - b.begin() == 6);
+	std::sort(b.begin(), b.end());
+	test(v == std::vector<int>{1, 2, 3, 4, 5, 6});
+	test(reverse(b).front() == 6);
+	test(prefetch(std::vector<int>{}).empty());
+
+	// gathers,  the elements are unchanged
+	auto const values = std::vector<int>{10, 20, 30, 40, 50};
+	auto const pointers = std::vector<int const*>{&values[4], &values[0], &values[3], &values[1]};
+	auto const indices = std::vector<uint32_t>{4, 0, 3, 1};
+
+	int gathered = 0;
+	for (auto const p : prefetch_pointee(pointers, 2)) gathered += *p;
+	test(gathered == 120);
+	test(prefetch_pointee(pointers, 100) == range(pointers));
+
+	gathered = 0;
+	for (auto const i : prefetch_indexed(indices, values.data(), 2)) gathered += values[i];
+	test(gathered == 120);
+	test(prefetch_indexed(indices, values.data()).drop(1).front() == 0);
+});
+
+describe("policies", [](auto test) {
+	auto v = std::vector<int>{1, 2, 3, 4};
+
+	auto u = unchecked(v);
+	static_assert(std::is_same_v<decltype(u)::policy, policy::unchecked>);
+	static_assert(std::is_same_v<decltype(range(u))::policy, policy::unchecked>);
+	static_assert(std::is_same_v<decltype(reverse(u))::policy, policy::unchecked>);
+	static_assert(std::is_same_v<decltype(u.drop(1))::policy, policy::unchecked>);
+	static_assert(std::is_same_v<decltype(range(v))::policy, policy::clamping>);
+	test(u.drop(1).take(2) == range(S123).drop(1));
+	test(u.back() == 4);
+	test(u[2] == 3);
+	test(u.pop_front(4).size() == 4);
+	test(u.empty());
+
+	auto c = clamping(v);
+	test(c.drop(10).empty());
+	test(c.take(10) == S1234);
+	test(c.pop_back(10).size() == 4);
+	test(c.empty());
+
+	auto t = trapping(v);
+	test(t.drop(4).empty());
+	test(t.take(4) == S1234);
+	test(t.drop_back(1).back() == 3);
+	test(t[3] == 4);
+
+	auto l = std::list<int>{1, 2, 3};
+	auto cl = clamping(l);
+	test(cl.drop(4).empty());
+	test(cl.drop(10).end() == l.end());
+	test(cl.take(10) == S123);
+	test(cl.drop_back(10).empty());
+	test(cl.drop_back(10).begin() == l.begin());
+	test(std::distance(cl.pop_front(5).begin(), l.end()) == 3);
+	test(cl.empty());
+
+	auto tl = trapping(l);
+	test(tl.drop(3).empty());
+	test(tl.drop(1).front() == 2);
+	test(tl.drop_back(1).back() == 2);
+
+#ifdef RANGER_DEATH_TESTS
+	test(traps([&]() { t.drop(5); }));
+	test(traps([&]() { t.take(5); }));
+	test(traps([&]() { (void) t[4]; }));
+	test(traps([&]() { tl.drop(4); }));
+	test(traps([&]() { tl.drop_back(4); }));
+	test(traps([&]() { trapping(l).drop(3).front(); }));
+	test(not traps([&]() { tl.drop(3); }));
+#endif
+
+	auto out = std::array<int, 4>{};
+	auto to = trapping(out);
+	test(to.put(range(v)));
+	test(to.empty());
+	test(out == S1234);
+});
+
 describe("ordered_range", [](auto test) {
 	auto v = std::vector<int>{1, 2, 3, 4};
 
@@ -513,6 +1526,70 @@ describe("input_iterators", [](auto) {
 	});
 });
 
+describe("channel", [](auto test) {
+	auto c = channel_t<int>(5);
+	test(c.capacity() == 8);
+	test(c.try_put(S123456) == 6);
+	test(c.try_put(S1234) == 2); // full
+	test(c.try_put(S1234) == 0);
+
+	auto out = std::vector<int>(4);
+	test(c.try_get(out) == 4);
+	test(out == std::vector<int>{1, 2, 3, 4});
+	test(c.try_put(std::list<int>{7, 8, 9}) == 3); // wraps
+	c.close();
+
+	auto a = input_range(c.begin());
+	test(a.front() == 5);
+	a.pop_front();
+	test(a == std::vector<int>{6, 1, 2, 7, 8, 9});
+	test(a.front() == 6); // cached
+	a.pop_front();
+	test(a.empty()); // exhausted
+
+	int x = 0;
+	test(not c.get(x)); // closed and drained
+	test(c.try_get(out) == 0);
+
+	// the cached head is reloaded when it shows less space than asked for,  not only none
+	auto e = channel_t<int>(4);
+	test(e.try_put(S123) == 3);
+	test(e.try_get(out) == 3);
+	test(e.try_put(S123) == 3);
+	test(e.try_get(out) == 3);
+	test(e.try_put(std::list<int>{1, 2, 3}) == 3);
+	test(e.try_put(S1234) == 1);
+
+	auto const line = [](auto const& x) { return reinterpret_cast<uintptr_t>(&x) / channel_t<int>::cache_line; };
+	test(line(e._closed) != line(e._tail));
+	test(line(e._closed) != line(e._head));
+
+	// threaded,  batches of varying size through a small ring
+	auto d = channel_t<uint32_t>(16);
+	auto producer = std::thread([&]() {
+		auto batch = std::vector<uint32_t>{};
+		for (uint32_t i = 0; i < 100000;) {
+			batch.clear();
+			for (uint32_t j = 0; j < i % 37 + 1 and i < 100000; ++j) batch.push_back(i++);
+			d.put(batch);
+		}
+		d.close();
+	});
+
+	uint64_t total = 0;
+	uint32_t expected = 0;
+	bool ordered = true;
+	for (auto const v : d) {
+		ordered = ordered and v == expected++;
+		total += v;
+	}
+
+	producer.join();
+	test(ordered);
+	test(expected == 100000);
+	test(total == uint64_t(99999) * 100000 / 2);
+});
+
 describe("put", [](auto) {
 	describe("element-wise", [&](auto test) {
 		auto data = std::array{1, 2, 3, 4};
@@ -596,6 +1673,182 @@ describe("all", [](auto test) {
 	test(va == range(S1234));
 });
 
+describe("scan", [](auto test) {
+	auto a = std::vector<int32_t>{1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11};
+	test(inclusive_scan(a) == 66);
+	test(a == std::vector<int32_t>{1, 3, 6, 10, 15, 21, 28, 36, 45, 55, 66});
+
+	auto b = std::vector<uint64_t>{1, 2, 3, 4, 5};
+	test(exclusive_scan(b, 10) == 25);
+	test(b == std::vector<uint64_t>{10, 11, 13, 16, 20});
+
+	auto c = std::vector<int64_t>{5, -1, 3};
+	test(inclusive_scan(range(c).drop(1), 5) == 7);
+	test(c == std::vector<int64_t>{5, 4, 7});
+
+	auto d = std::list<uint8_t>{1, 2, 3};
+	inclusive_scan(d);
+	test(d == std::list<uint8_t>{1, 3, 6});
+
+	auto e = std::vector<uint32_t>{};
+	test(inclusive_scan(e, 3) == 3);
+
+	// vectors reach the pointer (SSE2) kernels,  as their pointer ranges do
+	auto v = std::vector<int32_t>(37);
+	for (size_t i = 0; i < v.size(); ++i) v[i] = static_cast<int32_t>(i * 3) - 20;
+	static_assert(std::is_pointer_v<decltype(contiguous_range(v))::iterator>);
+	auto pv = v;
+	auto const vv = v;
+	auto dv = v;
+	test(exclusive_scan(v, 7) == exclusive_scan(ptr_range(pv), 7));
+	test(v == pv);
+	delta(dv, 4);
+	undelta(dv, 4);
+	test(dv == vv);
+	auto w = std::vector<int64_t>(v.begin(), v.end());
+	auto pw = w;
+	test(inclusive_scan(w) == inclusive_scan(ptr_range(pw)));
+	test(w == pw);
+
+	// matches a scalar scan across kernel remainders
+	for (size_t n = 0; n < 20; ++n) {
+		auto x = std::vector<uint32_t>(n);
+		auto y = std::vector<int64_t>(n);
+		for (size_t i = 0; i < n; ++i) {
+			x[i] = static_cast<uint32_t>(i * 2654435761u);
+			y[i] = static_cast<int64_t>(i * i) - 7;
+		}
+
+		auto ex = x;
+		auto ey = y;
+		for (size_t i = 1; i < n; ++i) {
+			ex[i] += ex[i - 1];
+			ey[i] += ey[i - 1];
+		}
+
+		inclusive_scan(x);
+		inclusive_scan(y);
+		test(x == ex);
+		test(y == ey);
+	}
+});
+
+describe("delta / zigzag", [](auto test) {
+	auto const timestamps = std::vector<int64_t>{1000, 1003, 1003, 1010, 1009, 1020};
+	auto t = timestamps;
+
+	delta(t, 1000);
+	test(t == std::vector<int64_t>{0, 3, 0, 7, -1, 11});
+	zigzag(t);
+	test(t == std::vector<int64_t>{0, 6, 0, 14, 1, 22});
+	unzigzag(t);
+	undelta(t, 1000);
+	test(t == timestamps);
+
+	test(zigzag_encode(int32_t(0)) == 0u);
+	test(zigzag_encode(int32_t(-1)) == 1u);
+	test(zigzag_encode(int32_t(1)) == 2u);
+	test(zigzag_encode(int32_t(-2)) == 3u);
+	test(zigzag_encode(INT32_MIN) == 0xffffffffu);
+	test(zigzag_decode(0xffffffffu) == INT32_MIN);
+	test(zigzag_decode(uint8_t(3)) == int8_t(-2));
+
+	auto u = std::vector<uint32_t>{0, 1, 2, 3};
+	unzigzag(u);
+	test(u == std::vector<uint32_t>{0, 0xffffffff, 1, 0xfffffffe});
+});
+
+describe("reductions", [](auto test) {
+	auto const va = range(S1234567);
+	test(va.sum() == 28);
+	test(va.sum(kahan) == 28);
+	test(va.sum(pairwise) == 28);
+	test(va.take(0).sum() == 0);
+	test(va.min() == 1);
+	test(va.max() == 7);
+	test(va.minmax() == std::make_pair(1, 7));
+	test(va.argmin() == 0);
+	test(va.argmax() == 6);
+
+	auto const mixed = std::vector<int>{4, -2, 9, -2, 9, 0};
+	test(range(mixed).min() == -2);
+	test(range(mixed).max() == 9);
+	test(range(mixed).argmin() == 1); // first
+	test(range(mixed).argmax() == 2); // first
+	test(range(mixed).minmax() == std::make_pair(-2, 9));
+	test(reverse(mixed).argmax() == 1);
+
+	auto const l = std::list<uint8_t>{200, 100, 50};
+	test(range(l).sum() == 350); // promoted
+	test(range(l).min() == 50);
+	test(range(l).argmin() == 2);
+
+	// floating point accuracy
+	auto values = std::vector<float>(100000, 0.1f);
+	values[0] = 1e8f;
+	auto const exact = 1e8 + 99999 * static_cast<double>(0.1f);
+	auto naive = 0.0f;
+	for (auto const x : values) naive += x;
+
+	auto const k = range(values).sum(kahan);
+	auto const p = range(values).sum(pairwise);
+	test(std::abs(naive - exact) > 1000);
+	test(std::abs(k - exact) < 16);
+	test(std::abs(p - exact) < std::abs(naive - exact));
+
+	auto d = std::vector<double>(1001);
+	for (size_t i = 0; i < d.size(); ++i) d[i] = static_cast<double>(i);
+	test(range(d).sum() == 500500.0);
+	test(range(d).sum(pairwise) == 500500.0);
+	test(range(d).drop(1).min() == 1.0);
+});
+
+describe("top_k", [](auto test) {
+	auto const numbers = std::array{5, 1, 7, 3, 6, 2, 4};
+	auto out = std::array<int, 4>{};
+
+	auto const a = range(numbers).top_k(3, range(out));
+	test(a == range(std::array{1, 2, 3}));
+	test(a.begin() == out.begin());
+
+	auto const b = range(numbers).top_k(2, range(out), std::greater<>());
+	test(b == range(std::array{7, 6}));
+
+	auto const c = range(numbers).top_k(10, range(out)); // k > out.size()
+	test(c == range(std::array{1, 2, 3, 4}));
+
+	auto const d = range(numbers).take(2).top_k(3, range(out)); // k > size()
+	test(d == range(std::array{1, 5}));
+
+	test(range(numbers).top_k(0, range(out)).empty());
+
+	auto l = std::list<int>{9, 8, 1, 4};
+	test(range(l).top_k(2, range(out)) == range(std::array{1, 4}));
+
+	// unmodified
+	test(numbers == std::array{5, 1, 7, 3, 6, 2, 4});
+});
+
+describe("nth", [](auto test) {
+	auto numbers = std::vector<int>{5, 1, 7, 3, 6, 2, 4};
+
+	auto const [left, right] = range(numbers).nth(3);
+	test(left.size() == 3);
+	test(right.size() == 4);
+	test(right.front() == 4);
+	test(left.all([](auto x) { return x < 4; }));
+	test(right.all([](auto x) { return x >= 4; }));
+
+	auto const [gl, gr] = range(numbers).nth(1, std::greater<>());
+	test(gl.size() == 1);
+	test(gl.front() == 7);
+	test(gr.front() == 6);
+
+	auto const [al, ar] = range(numbers).nth(10);
+	test(al == range(numbers));
+	test(ar.empty());
+});
+
 describe("contains", [](auto test) {
 	auto const va = range(S1234567);
 
@@ -623,6 +1876,120 @@ describe("contains", [](auto test) {
 	test(va == range(S1234567));
 });
 
+describe("contains (bytes)", [](auto test) {
+	auto const s = std::string("the cat sat on the mat");
+	auto const a = ptr_range(s);
+	auto const needle = [](std::string_view const z) { return range_t<char const*>(z.data(), z.data() + z.size()); };
+
+	test(a.contains(needle("the")));
+	test(a.contains(needle("mat")));
+	test(a.contains(needle("t s")));
+	test(a.contains(needle("")));
+	test(a.contains(a));
+	test(not a.contains(needle("mats")));
+	test(not a.contains(needle("cab")));
+	test(not a.contains(needle("the cat sat on the mat!")));
+	test(not a.drop(a.size()).contains(needle("")));
+	test(not a.drop(a.size()).contains(needle("t")));
+
+	// first byte matches up to the last possible position
+	test(not a.take(a.size() - 1).contains(needle("mat")));
+	test(a.take(a.size() - 1).contains(needle("ma")));
+});
+
+describe("join", [](auto test) {
+	auto const parts = std::vector<std::string>{"alpha", "", "beta", "gamma"};
+	auto const sep = std::string_view(", ");
+	test(joined_size(parts, sep) == 20);
+
+	auto buffer = std::string(32, '.');
+	auto out = ptr_range(buffer);
+	test(join(parts, sep, out));
+	test(out.size() == 12);
+	test(buffer.substr(0, 20) == "alpha, , beta, gamma");
+
+	// exact fit
+	auto exact = std::string(joined_size(parts, sep), '.');
+	auto e = ptr_range(exact);
+	test(join(parts, sep, e));
+	test(e.empty());
+	test(exact == "alpha, , beta, gamma");
+
+	// too small,  `out` unchanged
+	auto small = std::string(19, '.');
+	auto sm = ptr_range(small);
+	test(not join(parts, sep, sm));
+	test(sm.size() == 19);
+	test(sm.begin() == small.data());
+
+	// none,  or one
+	auto const none = std::vector<std::string>{};
+	test(joined_size(none, sep) == 0);
+	auto o = ptr_range(buffer);
+	test(join(none, sep, o));
+	test(o.size() == 32);
+
+	auto const one = std::vector<std::string_view>{"solo"};
+	test(joined_size(one, sep) == 4);
+	test(join(one, sep, o));
+	test(buffer.substr(0, 4) == "solo");
+
+	// not only bytes
+	auto const vs = std::vector<std::vector<int>>{{1, 2}, {3}};
+	auto ints = std::array<int, 4>{};
+	auto io = range(ints);
+	test(join(vs, std::array{0}, io));
+	test(ints == (std::array{1, 2, 0, 3}));
+});
+
+describe("replace_all", [](auto test) {
+	auto const s = std::string("the cat sat on the mat");
+
+	auto const replaced = [&](std::string_view const from, std::string_view const to) {
+		auto buffer = std::string(replaced_size(s, from, to), '.');
+		auto out = ptr_range(buffer);
+		auto const ok = replace_all(s, from, to, out);
+		return ok and out.empty() ? buffer : std::string("FAILED");
+	};
+
+	test(replaced("at", "og") == "the cog sog on the mog");
+	test(replaced("at", "ound") == "the cound sound on the mound");
+	test(replaced("the ", "") == "cat sat on mat");
+	test(replaced("dog", "cat") == s);
+	test(replaced("", "x") == s);
+	test(replaced(s, "!") == "!");
+
+	test(replaced_size(s, std::string_view("at"), std::string_view("ound")) == s.size() + 3 * 2);
+
+	// non-overlapping,  leftmost first
+	auto const aaaaa = std::string("aaaaa");
+	auto buffer = std::string(3, '.');
+	auto out = ptr_range(buffer);
+	test(replaced_size(aaaaa, std::string_view("aa"), std::string_view("b")) == 3);
+	test(replace_all(aaaaa, std::string_view("aa"), std::string_view("b"), out));
+	test(buffer == "bba");
+
+	// too small,  `out` unchanged
+	auto small = std::string(4, '.');
+	auto sm = ptr_range(small);
+	test(not replace_all(aaaaa, std::string_view("a"), std::string_view("xy"), sm));
+	test(sm.size() == 4);
+	test(sm.begin() == small.data());
+
+	// the tail too
+	auto six = std::string(6, '.');
+	auto nr = ptr_range(six);
+	test(not replace_all(std::string("abcabcxyz"), std::string_view("abc"), std::string_view("ab"), nr));
+	test(nr.size() == 6);
+
+	// not only bytes
+	auto const v = std::vector<int>{1, 2, 3, 1, 2, 4};
+	auto ints = std::array<int, 4>{};
+	auto io = range(ints);
+	test(replace_all(v, std::array{1, 2}, std::array{9}, io));
+	test(ints == (std::array{9, 3, 9, 4}));
+});
+
 describe("starts_with", [](auto test) {
 	auto const va = range(S1234567);
 
@@ -713,6 +2080,145 @@ describe("unto", [](auto test) {
 	test(fox.drop_back_unto(brown).empty()); // truncated
 });
 
+describe("split", [](auto test) {
+	auto const fields = split(zstr_range("a,bc,,d,"), ',');
+	auto expected = std::vector<std::string>{"a", "bc", "", "d", ""};
+	auto i = size_t(0);
+	for (auto const field : fields) {
+		test(i < expected.size());
+		test(field == expected[i]);
+		++i;
+	}
+	test(i == expected.size());
+
+	test(split(zstr_range(""), ',').count([](auto) { return true; }) == 1);
+	test(split(zstr_range(","), ',').count([](auto f) { return f.empty(); }) == 2);
+	test(split(zstr_range("abc"), ',').front() == zstr_range("abc"));
+	test(split(zstr_range("x y z"), ' ').drop(2).front() == zstr_range("z"));
+
+	auto q = split(zstr_range("a,\"b,c\",d,\"e"), ',', '"');
+	test(q.front() == zstr_range("a"));
+	test(q.drop(1).front() == zstr_range("\"b,c\""));
+	test(q.drop(2).front() == zstr_range("d"));
+	test(q.drop(3).front() == zstr_range("\"e"));
+	test(q.drop(4).empty());
+
+	auto any = split_any(zstr_range("GET /index.html\tHTTP/1.1"), zstr_range(" \t"));
+	test(any.front() == zstr_range("GET"));
+	test(any.drop(1).front() == zstr_range("/index.html"));
+	test(any.drop(2).front() == zstr_range("HTTP/1.1"));
+	test(any.drop(3).empty());
+
+	auto qa = split_any(zstr_range("k='a b' v"), zstr_range(" "), '\'');
+	test(qa.front() == zstr_range("k='a b'"));
+	test(qa.drop(1).front() == zstr_range("v"));
+
+	// non-byte elements
+	auto const numbers = std::vector<int>{1, 0, 2, 3, 0, 4};
+	auto n = split(numbers, 0);
+	test(n.front() == range(std::array{1}));
+	test(n.drop(1).front() == range(std::array{2, 3}));
+	test(n.drop(2).front() == range(std::array{4}));
+
+	auto l = std::list<char>{'a', ':', 'b'};
+	test(split(l, ':').drop(1).front().front() == 'b');
+});
+
+describe("search", [](auto test) {
+	auto const patterns = std::vector<std::string>{"he", "she", "his", "hers", ""};
+	auto const m = search::Matcher(patterns);
+	auto const h = zstr_range("ushers");
+
+	auto const all = m.all(h);
+	test(all.size() == 3);
+	test(all[0].pattern == 1 and all[0].begin == 1 and all[0].end == 4); // she
+	test(all[1].pattern == 0 and all[1].begin == 2 and all[1].end == 4); // he
+	test(all[2].pattern == 3 and all[2].begin == 2 and all[2].end == 6); // hers
+
+	auto const first = m.first(h);
+	test(first.has_value());
+	test(first->pattern == 1);
+
+	test(m.any(zstr_range("this")));
+	test(not m.any(zstr_range("abcdefg")));
+	test(not m.any(zstr_range("")));
+	test(not m.first(zstr_range("xyz")).has_value());
+
+	// containers with data(),  as pointer ranges
+	auto const sf = m.first(std::string("ushers"));
+	test(sf.has_value() and sf->pattern == 1 and sf->begin == 1);
+	test(m.all(std::string("ushers")).size() == 3);
+	test(not m.any(std::string("xyz")));
+
+	// single first byte (memchr prefilter)
+	auto const single = search::Matcher(std::vector<std::string>{"abc", "abd", "a"});
+	auto const bytes = std::vector<uint8_t>{'x', 'a', 'b', 'd', 'x', 'a'};
+	auto const found = single.all(ptr_range(bytes));
+	test(found.size() == 3);
+	test(found[0].pattern == 2 and found[0].begin == 1);
+	test(found[1].pattern == 1 and found[1].begin == 1 and found[1].end == 4);
+	test(found[2].pattern == 2 and found[2].begin == 5);
+
+	auto const vf = single.first(bytes);
+	test(vf.has_value() and vf->pattern == 2 and vf->begin == 1);
+	test(single.all(bytes).size() == 3);
+
+	// matches Range::contains
+	auto const words = std::vector<std::string>{"quick", "fox", "lazy", "dog", "jumped"};
+	auto const w = search::Matcher(words);
+	auto seen = std::vector<bool>(words.size());
+	w.each(TQBFJ, [&](auto const match) {
+		seen[match.pattern] = true;
+		return true;
+	});
+
+	for (size_t i = 0; i < words.size(); ++i) {
+		test(seen[i] == TQBFJ.contains(range(words[i])));
+	}
+});
+
+describe("hash", [](auto test) {
+	// XXH64 reference values
+	test(ranger::hash(zstr_range("")) == 0xEF46DB3751D8E999ULL);
+	test(ranger::hash(zstr_range("a")) == 0xD24EC4F1A98C6E5BULL);
+	test(ranger::hash(zstr_range("abc")) == 0x44BC2CF5AD770999ULL);
+
+	// consistent across range types,  lengths crossing the 32 byte stripes
+	auto const text = std::string("the quick brown fox jumped over the lazy dog, twice over");
+	for (size_t i = 0; i <= text.size(); ++i) {
+		auto const s = range(text).take(i);
+		auto const l = std::list<char>(s.begin(), s.end());
+		test(ranger::hash(s) == ranger::hash(l));
+		test(ranger::hash(s) == ranger::hash(std::string(s.begin(), s.end())));
+	}
+
+	// strings and vectors take the bulk (pointer) path,  equal to their pointer ranges
+	static_assert(std::is_pointer_v<decltype(contiguous_range(text))::iterator>);
+	auto big = std::string(65536, '\0');
+	for (size_t i = 0; i < big.size(); ++i) big[i] = static_cast<char>(i * 31);
+	auto state = __ranger::XXH64(0);
+	state.update(reinterpret_cast<uint8_t const*>(big.data()), big.size());
+	test(ranger::hash(big) == state.digest());
+	test(ranger::hash(big) == ranger::hash(ptr_range(big)));
+	test(ranger::hash(std::vector<char>(big.begin(), big.end())) == ranger::hash(ptr_range(big)));
+	test(range_hash()(big) == range_hash()(ptr_range(big)));
+
+	test(ranger::hash(TQBFJ) != ranger::hash(TQBFJ.drop(1)));
+	test(ranger::hash(TQBFJ) != ranger::hash(TQBFJ, 1));
+	test(ranger::hash(std::vector<std::string>{"a", "b"}) == ranger::hash(std::list<std::string>{"a", "b"}));
+
+	// range keyed maps,  no copies
+	auto counts = std::unordered_map<range_t<char const*>, size_t, range_hash, range_equal>{};
+	for (auto const word : split(zstr_range("a b a c b a"), ' ')) {
+		counts[word] += 1;
+	}
+
+	test(counts.size() == 3);
+	test(counts[zstr_range("a")] == 3);
+	test(counts[zstr_range("b")] == 2);
+	test(counts[zstr_range("c")] == 1);
+});
+
 describe("compat", [](auto test) {
 	auto v = std::vector<char>(10);
 	auto va = ptr_range(v);
@@ -734,6 +2240,70 @@ describe("compat", [](auto test) {
 	test(compat::read_from_chars(vb, 0) == -55);
 });
 
+#ifdef RANGER_STATS
+describe("stats", [](auto test) {
+	reset_stats();
+
+	auto l = std::list<int>{1, 2, 3, 4};
+	auto a = range(l);
+	a.pop_front(3);
+	test(stats().pop_front.calls == 1);
+	test(stats().pop_front.elements == 3); // walked
+
+	auto v = std::vector<int>{1, 2, 3, 4};
+	range(v).pop_front(3);
+	test(stats().pop_front.calls == 2);
+	test(stats().pop_front.elements == 3); // random access,  no walk
+
+	// one call each,  the positions searched as elements
+	test(range(v).contains(range(std::array{3, 4})));
+	test(stats().contains.calls == 1);
+	test(stats().contains.elements == 2);
+
+	auto const many = std::list<int>(1000, 1);
+	test(not range(many).contains(range(std::array{2})));
+	test(stats().contains.calls == 2);
+	test(stats().contains.elements == 2 + 1000);
+
+	auto const text = std::string("hello world");
+	auto const world = std::string("world");
+	test(ptr_range(text).contains(ptr_range(world)));
+	test(stats().contains.calls == 3);
+	test(stats().contains.elements == 2 + 1000 + 6);
+
+	auto const missing = std::string("worlds");
+	test(not ptr_range(text).contains(ptr_range(missing)));
+	test(stats().contains.calls == 4);
+	test(stats().contains.elements == 2 + 1000 + 6 + 11);
+
+	// one call each,  the elements copied
+	auto out = std::array<int, 4>{};
+	range(out).put(range(v));
+	test(stats().put.calls == 1);
+	test(stats().put.elements == 4);
+	test(stats().put.bytes == 4 * sizeof(int));
+
+	auto small = std::array<int, 2>{};
+	test(not range(small).put(range(v)));
+	test(stats().put.calls == 2);
+	test(stats().put.elements == 4 + 2);
+	test(stats().put.bytes == 6 * sizeof(int));
+
+	auto bytes = std::array<uint8_t, 4>{};
+	serial::put<uint32_t>(range(bytes), 7);
+	test(serial::read<uint32_t>(range(bytes)) == 7);
+	test(stats().serial_put.calls == 1);
+	test(stats().serial_put.bytes == 4);
+	test(stats().serial_read.calls == 1);
+	test(stats().serial_read.elements == 0);
+	test(stats().serial_read.bytes == 4);
+
+	auto report = std::stringstream{};
+	report_stats(report);
+	test(report.str().find("serial::read 1 0 4") != std::string::npos);
+});
+#endif
+
 // test nothing has been modified
 describe("no modifications", [&](auto test) {
 	test(S123 == std::array{1, 2, 3});
@@ -0,0 +1,269 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <type_traits>
+#include "ranger.hpp"
+
+namespace __ranger {
+	inline constexpr uint64_t utf8_high_bits = 0x8080808080808080ULL;
+
+	inline uint64_t utf8_load64 (uint8_t const* p) {
+		uint64_t x;
+		std::memcpy(&x, p, sizeof(x));
+		return x;
+	}
+
+	// decodes the sequence at `p` (of `n` bytes available) into `cp`
+	// returns its length,  or 0 if invalid (overlong, surrogate, out of range, or truncated)
+	inline size_t utf8_decode (uint8_t const* const p, size_t const n, char32_t& cp) {
+		auto const b0 = p[0];
+		if (b0 < 0x80) {
+			cp = b0;
+			return 1;
+		}
+
+		auto const continuation = [](uint8_t const b) { return (b & 0xC0) == 0x80; };
+
+		if (b0 >= 0xC2 and b0 <= 0xDF) {
+			if (n < 2 or not continuation(p[1])) return 0;
+			cp = static_cast<char32_t>(((b0 & 0x1Fu) << 6) | (p[1] & 0x3Fu));
+			return 2;
+		}
+
+		if (b0 >= 0xE0 and b0 <= 0xEF) {
+			if (n < 3 or not continuation(p[1]) or not continuation(p[2])) return 0;
+			if (b0 == 0xE0 and p[1] < 0xA0) return 0; // overlong
+			if (b0 == 0xED and p[1] > 0x9F) return 0; // surrogate
+			cp = static_cast<char32_t>(((b0 & 0x0Fu) << 12) | ((p[1] & 0x3Fu) << 6) | (p[2] & 0x3Fu));
+			return 3;
+		}
+
+		if (b0 >= 0xF0 and b0 <= 0xF4) {
+			if (n < 4 or not continuation(p[1]) or not continuation(p[2]) or not continuation(p[3])) return 0;
+			if (b0 == 0xF0 and p[1] < 0x90) return 0; // overlong
+			if (b0 == 0xF4 and p[1] > 0x8F) return 0; // > U+10FFFF
+			cp = static_cast<char32_t>(((b0 & 0x07u) << 18) | ((p[1] & 0x3Fu) << 12) | ((p[2] & 0x3Fu) << 6) | (p[3] & 0x3Fu));
+			return 4;
+		}
+
+		return 0;
+	}
+
+	// the length of the ASCII prefix,  16 bytes (two 64-bit words) at a time
+	inline size_t utf8_ascii (uint8_t const* const begin, uint8_t const* const end) {
+		auto p = begin;
+		for (; end - p >= 16; p += 16) {
+			if (((utf8_load64(p) | utf8_load64(p + 8)) & utf8_high_bits) != 0) break;
+		}
+
+		while (p != end and *p < 0x80) ++p;
+		return static_cast<size_t>(p - begin);
+	}
+
+	// the first byte of the first invalid sequence,  or `end`
+	inline uint8_t const* utf8_invalid (uint8_t const* p, uint8_t const* const end) {
+		while (p != end) {
+			p += utf8_ascii(p, end);
+			if (p == end) break;
+
+			char32_t cp;
+			auto const n = utf8_decode(p, static_cast<size_t>(end - p), cp);
+			if (n == 0) return p;
+			p += n;
+		}
+
+		return p;
+	}
+
+	// `r` (a byte pointer range,  or a contiguous container of bytes) as uint8_t
+	template <typename R>
+	auto utf8_bytes (R const& r) {
+		auto const a = [&]() {
+			if constexpr(has_data<R const>::value) {
+				return ranger::ptr_range(r);
+			} else {
+				return ranger::range(r);
+			}
+		}();
+
+		static_assert(is_byte_pointer<typename decltype(a)::iterator>(), "Expected a byte pointer range");
+		return Range<uint8_t const*>(reinterpret_cast<uint8_t const*>(a.begin()), reinterpret_cast<uint8_t const*>(a.end()));
+	}
+
+	// a forward iterator over the code points of UTF-8 bytes,  invalid sequences are U+FFFD (one per byte)
+	struct Utf8Iterator {
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = char32_t;
+		using difference_type = std::ptrdiff_t;
+		using pointer = void;
+		using reference = char32_t;
+
+		uint8_t const* _it;
+		uint8_t const* _end;
+
+		constexpr Utf8Iterator () : _it(), _end() {}
+		constexpr Utf8Iterator (uint8_t const* it, uint8_t const* end) : _it(it), _end(end) {}
+
+		auto base () const { return this->_it; }
+
+		auto decode (char32_t& cp) const {
+			auto const n = utf8_decode(this->_it, static_cast<size_t>(this->_end - this->_it), cp);
+			if (n == 0) cp = 0xFFFD;
+			return n == 0 ? 1 : n;
+		}
+
+		char32_t operator* () const {
+			char32_t cp;
+			this->decode(cp);
+			return cp;
+		}
+
+		auto& operator++ () {
+			char32_t cp;
+			this->_it += this->decode(cp);
+			return *this;
+		}
+
+		auto operator++ (int) {
+			auto copy = *this;
+			++*this;
+			return copy;
+		}
+
+		bool operator== (Utf8Iterator const& b) const { return this->_it == b._it; }
+		bool operator!= (Utf8Iterator const& b) const { return this->_it != b._it; }
+	};
+
+	// writes the code points of `in` to `out` via `f(cp, out)`,  which returns false if `out` is full
+	// advances `in` past what was written,  returns false if stopped early (an invalid sequence,  or `out` full)
+	template <typename A, typename B, typename F>
+	bool utf8_transcode (A& in, B& out, F const f) {
+		auto const bytes = utf8_bytes(in);
+		auto const begin = bytes.begin();
+		auto const end = bytes.end();
+		auto p = begin;
+		auto ok = true;
+
+		while (p != end) {
+			// ASCII runs,  widened in bulk for random access outputs
+			auto const ascii = utf8_ascii(p, end);
+			auto const q = p + ascii;
+			if constexpr(B::is_random_access::value) {
+				auto const k = std::min(ascii, out.size());
+				std::copy(p, p + k, out.begin());
+				out.pop_front(k);
+				p += k;
+			} else {
+				for (; p != q; ++p) {
+					if (not f(static_cast<char32_t>(*p), out)) break;
+				}
+			}
+
+			if (p != q) {
+				ok = false;
+				break;
+			}
+
+			if (p == end) break;
+
+			char32_t cp;
+			auto const n = utf8_decode(p, static_cast<size_t>(end - p), cp);
+			if (n == 0 or not f(cp, out)) {
+				ok = false;
+				break;
+			}
+
+			p += n;
+		}
+
+		in = in.drop(static_cast<size_t>(p - begin));
+		return ok;
+	}
+}
+
+namespace ranger::utf8 {
+	// true if `r` (a byte pointer range) is well formed UTF-8
+	template <typename R>
+	bool validate (R const& r) {
+		auto const bytes = __ranger::utf8_bytes(r);
+		return __ranger::utf8_invalid(bytes.begin(), bytes.end()) == bytes.end();
+	}
+
+	// the length of the longest valid prefix of `r`,  in bytes
+	template <typename R>
+	size_t valid_prefix (R const& r) {
+		auto const bytes = __ranger::utf8_bytes(r);
+		return static_cast<size_t>(__ranger::utf8_invalid(bytes.begin(), bytes.end()) - bytes.begin());
+	}
+
+	// a lazy range of the code points (char32_t) in `r`,  invalid sequences decode as U+FFFD
+	template <typename R>
+	auto code_points (R& r) {
+		using iterator = __ranger::Utf8Iterator;
+
+		auto const a = __ranger::utf8_bytes(r);
+		return range_t<iterator>(iterator(a.begin(), a.end()), iterator(a.end(), a.end()));
+	}
+
+	template <typename R>
+	auto code_points (R&& r) { return code_points<R>(r); }
+
+	// the number of UTF-32/UTF-16 code units needed for `r`,  which must be valid UTF-8
+	template <typename R>
+	size_t utf32_length (R const& r) {
+		size_t result = 0;
+		for (auto const b : __ranger::utf8_bytes(r)) result += (b & 0xC0) != 0x80;
+		return result;
+	}
+
+	template <typename R>
+	size_t utf16_length (R const& r) {
+		size_t result = 0;
+		for (auto const b : __ranger::utf8_bytes(r)) result += ((b & 0xC0) != 0x80) + (b >= 0xF0);
+		return result;
+	}
+
+	// transcodes UTF-8 `in` to `out`,  advancing both
+	// returns false if stopped early,  at an invalid sequence (`in` is left at it) or because `out` is full
+	template <typename A, typename B>
+	bool to_utf32 (A& in, B& out) {
+		using T = typename B::value_type;
+
+		return __ranger::utf8_transcode(in, out, [](char32_t const cp, B& o) {
+			if (o.empty()) return false;
+			o.front() = static_cast<T>(cp);
+			o.pop_front();
+			return true;
+		});
+	}
+
+	template <typename A, typename B>
+	bool to_utf16 (A& in, B& out) {
+		using T = typename B::value_type;
+
+		return __ranger::utf8_transcode(in, out, [](char32_t const cp, B& o) {
+			if (o.empty()) return false;
+
+			if (cp < 0x10000) {
+				o.front() = static_cast<T>(cp);
+				o.pop_front();
+				return true;
+			}
+
+			// a surrogate pair,  or nothing
+			auto second = o;
+			second.pop_front();
+			if (second.empty()) return false;
+
+			auto const v = cp - 0x10000;
+			o.front() = static_cast<T>(0xD800 + (v >> 10));
+			o.pop_front();
+			o.front() = static_cast<T>(0xDC00 + (v & 0x3FF));
+			o.pop_front();
+			return true;
+		});
+	}
+}